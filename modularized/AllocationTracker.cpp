@@ -0,0 +1,49 @@
+#include "AllocationTracker.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Per-thread, so counting needs no atomics and each session sees only its own allocations
+thread_local unsigned long long allocationCount = 0;
+
+void* allocate(std::size_t size) {
+    ++allocationCount;
+    if (size == 0) size = 1;
+    while (true) {
+        if (void* memory = std::malloc(size)) return memory;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+} // namespace
+
+unsigned long long AllocationTracker::threadAllocations() {
+    return allocationCount;
+}
+
+void* operator new(std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return allocate(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
@@ -0,0 +1,11 @@
+#ifndef ALLOCATIONTRACKER_H
+#define ALLOCATIONTRACKER_H
+
+// Counts heap allocations made through the global operator new, which is replaced in AllocationTracker.cpp
+class AllocationTracker {
+public:
+    // Allocations made so far by the calling thread
+    static unsigned long long threadAllocations();
+};
+
+#endif // ALLOCATIONTRACKER_H
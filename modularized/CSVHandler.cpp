@@ -1,111 +1,125 @@
 #include "CSVHandler.h"
+#include "FastCSVParser.h"
+#include "Metrics.h"
 #include <fstream>
-#include <sstream>
 #include <iostream>
 #include <iomanip>
 
-// Function to trim leading and trailing whitespaces
-void trim(std::string& s) {
-    size_t start = s.find_first_not_of(" \t\r\n");
-    size_t end = s.find_last_not_of(" \t\r\n");
-
-    if (start != std::string::npos && end != std::string::npos) {
-        s = s.substr(start, end - start + 1);
-    }
-    else {
-        s.clear();
-    }
-}
-
-std::vector<Order> CSVHandler::readCSV(const std::string& filename) {
+std::vector<Order> CSVHandler::readCSV(const std::string& filename, unsigned parseThreads) {
     std::vector<Order> orders;
-    std::ifstream file(filename);
 
     // Raise error if file cannot be opened
-    if (!file.is_open()) {
+    if (!inputParser.load(filename)) {
         std::cerr << "Error opening file: " << filename << std::endl;
         return orders;
     }
-    std::string line;
-    int orderCounter = 1;
 
-    // Skip the first row (header row)
-    if (std::getline(file, line)) {
-        // Optional: You could log the header if needed.
-    }
+    // Header row is skipped by the parser
+    inputParser.parseOrdersParallel(orders, parseThreads);
+    return orders;
+}
 
-    // Read CSV line by line
-    while (std::getline(file, line)) {
-        std::istringstream ss(line);
-        std::string clientOrder, instrument, sideStr, quantityStr, priceStr;
-        
-        std::getline(ss, clientOrder, ',');
-        std::getline(ss, instrument, ',');
-        std::getline(ss, sideStr, ',');
-        std::getline(ss, quantityStr, ',');
-        std::getline(ss, priceStr, ',');
-
-        trim(sideStr);
-        trim(instrument);
-        
-        int quantity = std::stoi(quantityStr);
-        int side = std::stoi(sideStr);
-        double price = std::stod(priceStr);
-
-        std::string ord = "ord" + std::to_string(orderCounter++);
-
-        orders.emplace_back(ord, clientOrder, instrument, side, 0, quantity, price);
+// Function to get the open report stream for a file, opening it for appending if needed
+std::ofstream* CSVHandler::reportStream(const std::string& filename) {
+    if (!reportFile.is_open() || reportFilename != filename) {
+        closeReport();
+        reportFile.open(filename, std::ios_base::app);
+        if (!reportFile.is_open()) {
+            std::cerr << "Error opening file: " << filename << std::endl;
+            return nullptr;
+        }
+        reportFilename = filename;
     }
+    return &reportFile;
+}
 
-    file.close();
-    return orders;
+// Function to flush and close the report file
+void CSVHandler::closeReport() {
+    if (reportFile.is_open()) reportFile.close();
+    reportFilename.clear();
+}
+
+void CSVHandler::forwardReports(SPSCQueue<ReportRecord>* queue, WaitStrategy wait) {
+    reportQueue = queue;
+    reportWait = wait;
 }
 
 // Function to write a single order to CSV file
-void CSVHandler::writeOrderToCSV(const std::string& filename, const Order& order, const std::string& reason) {
-    std::ofstream file(filename, std::ios_base::app);
-    if (!file.is_open()) {
-        std::cerr << "Error opening file: " << filename << std::endl;
+void CSVHandler::writeOrderToCSV(const std::string& filename, const Order& order, const char* reason) {
+    if (reportQueue) {
+        Backoff backoff(reportWait);
+        while (!reportQueue->tryEmplace(order, reason)) backoff.pause();
+        Metrics::recordQueueDepth(QueueStage::Reporting, 1);
+        return;
+    }
+
+    Metrics::recordReport(order.status, reason);
+
+    std::ofstream* file = reportStream(filename);
+    if (!file) return;
+    writeRow(*file, order, reason);
+}
+
+// Function to write a batch of orders to CSV file, looking up the report stream once
+void CSVHandler::writeOrdersToCSV(const std::string& filename, const std::vector<Order>& orders) {
+    if (reportQueue) {
+        for (const Order& order : orders) writeOrderToCSV(filename, order);
         return;
     }
 
-    std::string status = (order.status == 0 ? "New" :
+    std::ofstream* file = reportStream(filename);
+    if (!file) return;
+    for (const Order& order : orders) {
+        Metrics::recordReport(order.status, "");
+        writeRow(*file, order, "");
+    }
+}
+
+// Function to format one execution report row
+void CSVHandler::writeRow(std::ofstream& file, const Order& order, const char* reason) {
+    const char* status = (order.status == 0 ? "New" :
                           order.status == 1 ? "Rejected" :
                           order.status == 2 ? "Fill" :
-                          order.status == 3 ? "Pfill" : "Unknown");
+                          order.status == 3 ? "Pfill" :
+                          order.status == 4 ? "Canceled" : "Unknown");
 
-    file << order.ord << "," << order.clientOrder << "," << order.instrument << ","
+    file << "ord" << order.orderNumber << "," << order.clientOrder << "," << order.instrument << ","
          << order.side << "," << status << "," << order.quantity << ","
          << std::fixed << std::setprecision(2) << order.price;
 
-    if (!reason.empty()) {
+    if (reason[0] != '\0') {
         file << "," << reason;
     }
 
-    file << std::endl;
-    file.close();
+    file << '\n';
 }
 
 // Function to write the heading to CSV file
 void CSVHandler::writeHeadingToCSV(const std::string& filename) {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
+    closeReport();
+    reportFile.open(filename);
+    if (!reportFile.is_open()) {
         std::cerr << "Error opening file: " << filename << std::endl;
         return;
     }
-    file << "Order ID" << "," << "Cl. Ord. ID" << "," << "Instrument" << ","
-         << "Side" << "," << "Status" << "," << "Quantity" << ","
-         << "Price" << "," << "Reason" << std::endl;
-    file.close();
+    reportFilename = filename;
+    reportFile << "Order ID" << "," << "Cl. Ord. ID" << "," << "Instrument" << ","
+               << "Side" << "," << "Status" << "," << "Quantity" << ","
+               << "Price" << "," << "Reason" << '\n';
 }
 
 // Function to write the execution time to CSV file
 void CSVHandler::writeExecutionTimeToCSV(const std::string& filename, long long executionTime) {
-    std::ofstream file(filename, std::ios_base::app);
-    if (!file.is_open()) {
-        std::cerr << "Error opening file: " << filename << std::endl;
-        return;
-    }
-    file << "Execution Time (ms)," << executionTime << std::endl;
-    file.close();
-}
\ No newline at end of file
+    std::ofstream* file = reportStream(filename);
+    if (!file) return;
+    *file << "Execution Time (ms)," << executionTime << std::endl;
+}
+
+// Function to write the heap allocation count of the matching loop to CSV file
+void CSVHandler::writeAllocationsToCSV(const std::string& filename, unsigned long long allocations, std::size_t orderCount) {
+    std::ofstream* file = reportStream(filename);
+    if (!file) return;
+    *file << "Allocations," << allocations << '\n'
+          << "Allocations per order," << std::fixed << std::setprecision(2)
+          << (orderCount > 0 ? static_cast<double>(allocations) / orderCount : 0.0) << std::endl;
+}
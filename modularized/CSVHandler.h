@@ -1,16 +1,44 @@
 #ifndef CSVHANDLER_H
 #define CSVHANDLER_H
 
+#include <fstream>
 #include <vector>
 #include <string>
+#include "FastCSVParser.h"
 #include "Order.h"
+#include "SPSCQueue.h"
+
+// An execution report row waiting for the reporting thread
+struct ReportRecord {
+    Order order;
+    const char* reason;
+
+    ReportRecord(const Order& order, const char* reason) : order(order), reason(reason) {}
+};
 
 class CSVHandler {
+private:
+    FastCSVParser inputParser; // Holds the input text that the orders from readCSV point into
+    std::ofstream reportFile; // Kept open between writes so reporting does not allocate per row
+    std::string reportFilename;
+    SPSCQueue<ReportRecord>* reportQueue = nullptr; // When set, rows go to the reporting thread instead
+    WaitStrategy reportWait = WaitStrategy::Adaptive;
+
+    std::ofstream* reportStream(const std::string& filename);
+    void writeRow(std::ofstream& file, const Order& order, const char* reason);
+
 public:
-    std::vector<Order> readCSV(const std::string& filename);
-    void writeOrderToCSV(const std::string& filename, const Order& order, const std::string& reason = "");
+    // The orders stay valid until the next readCSV call or until this handler is destroyed
+    std::vector<Order> readCSV(const std::string& filename, unsigned parseThreads = 1);
+    void writeOrderToCSV(const std::string& filename, const Order& order, const char* reason = "");
+    void writeOrdersToCSV(const std::string& filename, const std::vector<Order>& orders);
     void writeHeadingToCSV(const std::string& filename);
     void writeExecutionTimeToCSV(const std::string& filename, long long executionTime);
+    void writeAllocationsToCSV(const std::string& filename, unsigned long long allocations, std::size_t orderCount);
+    void closeReport();
+
+    // Send order rows to a reporting thread through queue, or write them directly again with nullptr
+    void forwardReports(SPSCQueue<ReportRecord>* queue, WaitStrategy wait);
 };
 
 #endif // CSVHANDLER_H
\ No newline at end of file
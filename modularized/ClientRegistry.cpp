@@ -0,0 +1,17 @@
+#include "ClientRegistry.h"
+
+int ClientRegistry::intern(std::string_view name) {
+    if (name.empty()) return 0;
+
+    auto it = ids.find(name);
+    if (it != ids.end()) return it->second;
+
+    names.emplace_back(name);
+    int id = static_cast<int>(names.size());
+    ids.emplace(names.back(), id);
+    return id;
+}
+
+int ClientRegistry::size() const {
+    return static_cast<int>(names.size());
+}
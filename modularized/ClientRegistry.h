@@ -0,0 +1,21 @@
+#ifndef CLIENTREGISTRY_H
+#define CLIENTREGISTRY_H
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Maps client names to small integer ids so the order book compares owners as integers
+class ClientRegistry {
+private:
+    std::unordered_map<std::string_view, int> ids; // Keys view the names below
+    std::deque<std::string> names; // Client with id i is names[i - 1], a deque so the keys never move
+
+public:
+    // Returns the id for a client, 0 for an empty name
+    int intern(std::string_view name);
+    int size() const;
+};
+
+#endif // CLIENTREGISTRY_H
@@ -0,0 +1,49 @@
+#ifndef ENGINECONFIG_H
+#define ENGINECONFIG_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// What happens when an order would trade against a resting order of the same client
+enum class SelfTradePrevention {
+    None,         // Orders of the same client match normally
+    CancelNewest, // Cancel the incoming order
+    CancelOldest, // Cancel the resting order and keep matching
+    Decrement     // Reduce both by the smaller quantity and cancel the smaller order
+};
+
+// How pipeline threads wait on an empty or full queue
+enum class WaitStrategy {
+    BusyPoll, // Spin on the queue, lowest latency, keeps the core busy
+    Adaptive  // Spin for a while, then yield the core between polls
+};
+
+// Runtime options given on the command line after the input and output filenames
+struct EngineConfig {
+    unsigned parseThreads = 1;    // Threads used to parse the input file
+    bool trace = true;            // Print the order book trace to stdout
+    unsigned sessionWorkers = 0;  // Worker threads hosting sessions, 0 = one per session up to the CPU count
+    std::vector<int> sessionCpus; // CPU for each session worker, defaults to the allowed CPUs in turn
+    SelfTradePrevention selfTradePrevention = SelfTradePrevention::None;
+    bool cancelOnDisconnect = false; // Cancel each client's resting orders when the session input ends
+    bool allocationStats = false;    // Report heap allocations per processed order
+    bool zeroAllocation = false;     // Preallocate the book and fail the run if matching allocates
+    double priceBand = 0;            // Reject prices further than this fraction from the last trade, 0 = off
+    double haltMove = 0;             // Halt an instrument after its price moves this fraction, 0 = off
+    int haltOrders = 10;             // Orders rejected for an instrument while it is halted
+    std::vector<double> referencePrices; // Starting band reference per instrument (Order::instrumentNames order),
+                                         // 0 = the instrument's first resting order price
+    std::string metricsFilename;     // Prometheus text file refreshed while running, empty = off
+    int metricsIntervalMs = 1000;
+    bool pipeline = false;           // Run ingest, matching and reporting on their own threads
+    int ingestCpu = -1;              // CPU for each pipeline stage, -1 = not pinned
+    int matchCpu = -1;
+    int reportCpu = -1;
+    WaitStrategy waitStrategy = WaitStrategy::Adaptive;
+    std::size_t queueCapacity = 65536; // Slots in each inter-stage queue
+    long long auctionOrders = 0;     // Orders collected by the opening call auction before it uncrosses, 0 = off
+    bool periodicAuction = false;    // Run a new call auction for every auctionOrders orders instead of trading continuously
+};
+
+#endif // ENGINECONFIG_H
@@ -0,0 +1,397 @@
+#include "FastCSVParser.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <thread>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define FLOWER_X86_SIMD 1
+#elif defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#include <emmintrin.h>
+#define FLOWER_SSE2_ONLY 1
+#endif
+
+namespace {
+
+// Bytes scanned per delimiter mask
+const std::size_t kBlockSize = 64;
+
+// Bytes read ahead of a field by the 8-byte digit loads and the block scanner
+const std::size_t kPadding = 64;
+
+// Input columns: Cl. Ord. ID,Instrument,Side,Quantity,Price and the optional Client and Peak
+const int kFieldCount = 7;
+
+// Rows parsed per batch in forEachOrder, keeps the temporary row array small
+const std::size_t kBatchBytes = 1 << 20;
+
+using MaskFunction = std::uint64_t (*)(const char*);
+
+// Bit i is set when p[i] is a comma or a newline
+std::uint64_t delimiterMaskScalar(const char* p) {
+    std::uint64_t mask = 0;
+    for (std::size_t i = 0; i < kBlockSize; ++i) {
+        if (p[i] == ',' || p[i] == '\n') mask |= std::uint64_t(1) << i;
+    }
+    return mask;
+}
+
+#if defined(FLOWER_X86_SIMD) || defined(FLOWER_SSE2_ONLY)
+#if defined(FLOWER_X86_SIMD)
+__attribute__((target("sse2")))
+#endif
+std::uint64_t delimiterMaskSSE2(const char* p) {
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    std::uint64_t mask = 0;
+    for (int i = 0; i < 4; ++i) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, comma), _mm_cmpeq_epi8(chunk, newline));
+        mask |= std::uint64_t(static_cast<std::uint32_t>(_mm_movemask_epi8(hits)) & 0xFFFF) << (16 * i);
+    }
+    return mask;
+}
+#endif
+
+#if defined(FLOWER_X86_SIMD)
+__attribute__((target("avx2")))
+std::uint64_t delimiterMaskAVX2(const char* p) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+    std::uint32_t maskLo = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(lo, comma), _mm256_cmpeq_epi8(lo, newline))));
+    std::uint32_t maskHi = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(hi, comma), _mm256_cmpeq_epi8(hi, newline))));
+    return maskLo | (std::uint64_t(maskHi) << 32);
+}
+#endif
+
+// Pick the widest scanner the CPU supports, once
+MaskFunction delimiterScanner() {
+    static const MaskFunction scanner = []() -> MaskFunction {
+#if defined(FLOWER_X86_SIMD)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return delimiterMaskAVX2;
+        if (__builtin_cpu_supports("sse2")) return delimiterMaskSSE2;
+#elif defined(FLOWER_SSE2_ONLY)
+        return delimiterMaskSSE2;
+#endif
+        return delimiterMaskScalar;
+    }();
+    return scanner;
+}
+
+int countTrailingZeros(std::uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+// Little-endian 8-byte load, the first character ends up in the lowest byte
+std::uint64_t load8(const char* p) {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+// Parse the run of up to 8 decimal digits at p without a per-character loop.
+// Returns the number of digits consumed (0 when p does not start with a digit,
+// 9 when the run is longer than 8 digits and the caller must fall back).
+int parseDigits(const char* p, std::uint32_t& value) {
+    std::uint64_t v = load8(p) ^ 0x3030303030303030ULL; // Digits become 0..9
+    std::uint64_t nonDigit = (((v & 0x7F7F7F7F7F7F7F7FULL) + 0x7676767676767676ULL) | v) & 0x8080808080808080ULL;
+    int length = nonDigit ? countTrailingZeros(nonDigit) / 8 : 8;
+    if (length == 0) return 0;
+    if (length == 8 && p[8] >= '0' && p[8] <= '9') return 9;
+
+    // Right-align the digits so the padding bytes act as leading zeros
+    v <<= 8 * (8 - length);
+    v = (v * 10) + (v >> 8);
+    v = (((v & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+         (((v >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    value = static_cast<std::uint32_t>(v);
+    return length;
+}
+
+bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Strip leading and trailing whitespaces
+std::string_view trimView(std::string_view s) {
+    std::size_t start = 0;
+    std::size_t end = s.size();
+    while (start < end && isBlank(s[start])) ++start;
+    while (end > start && isBlank(s[end - 1])) --end;
+    return s.substr(start, end - start);
+}
+
+// Only whitespace may follow a number handled by the fast path
+bool onlyBlanks(const char* p, const char* end) {
+    for (; p < end; ++p) {
+        if (!isBlank(*p)) return false;
+    }
+    return true;
+}
+
+bool parseIntegerField(std::string_view field, int& out) {
+    const char* p = field.data();
+    const char* end = p + field.size();
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    if (p == end) return false;
+
+    std::uint32_t value;
+    int length = parseDigits(p, value);
+    if (length == 0 || length > 8 || p + length > end) return false;
+    if (!onlyBlanks(p + length, end)) return false;
+    out = static_cast<int>(value);
+    return true;
+}
+
+// Accepts plain decimals with at most two fractional digits, e.g. "55", "55.5", "55.00"
+bool parsePriceField(std::string_view field, long long& ticks) {
+    const char* p = field.data();
+    const char* end = p + field.size();
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    if (p == end) return false;
+
+    std::uint32_t whole;
+    int length = parseDigits(p, whole);
+    if (length == 0 || length > 8 || p + length > end) return false;
+    p += length;
+
+    std::uint32_t fraction = 0;
+    if (p < end && *p == '.') {
+        ++p;
+        int fractionLength = 0;
+        if (p < end) {
+            fractionLength = parseDigits(p, fraction);
+            if (fractionLength > 2 || p + fractionLength > end) return false;
+        }
+        if (fractionLength == 1) fraction *= 10;
+        p += fractionLength;
+    }
+    if (!onlyBlanks(p, end)) return false;
+
+    ticks = static_cast<long long>(whole) * 100 + fraction;
+    return true;
+}
+
+CSVRow makeRow(const std::string_view (&fields)[kFieldCount]) {
+    CSVRow row;
+    row.clientOrder = fields[0];
+    row.instrument = trimView(fields[1]);
+    row.sideField = trimView(fields[2]);
+    row.quantityField = fields[3];
+    row.priceField = fields[4];
+    row.client = trimView(fields[5]);
+    row.peakField = trimView(fields[6]);
+    row.side = 0;
+    row.quantity = 0;
+    row.priceTicks = 0;
+    row.peak = 0;
+    row.fastNumeric = parseIntegerField(row.sideField, row.side) &&
+                      parseIntegerField(row.quantityField, row.quantity) &&
+                      parsePriceField(row.priceField, row.priceTicks) &&
+                      (row.peakField.empty() || parseIntegerField(row.peakField, row.peak));
+    return row;
+}
+
+// First line start at or after p
+const char* nextLineStart(const char* p, const char* end) {
+    if (p >= end) return end;
+    const void* newline = std::memchr(p, '\n', end - p);
+    return newline ? static_cast<const char*>(newline) + 1 : end;
+}
+
+// Run task(0) .. task(count - 1) on their own threads and rethrow the first failure
+template <typename Task>
+void runParallel(unsigned count, Task task) {
+    std::vector<std::exception_ptr> errors(count);
+    std::vector<std::thread> workers;
+    workers.reserve(count);
+    for (unsigned i = 0; i < count; ++i) {
+        workers.emplace_back([&, i]() {
+            try {
+                task(i);
+            }
+            catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+    for (std::exception_ptr& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+} // namespace
+
+bool FastCSVParser::load(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+
+    std::streamsize size = file.tellg();
+    file.seekg(0);
+    buffer.assign(static_cast<std::size_t>(size) + kPadding, '\0');
+    if (size > 0 && !file.read(&buffer[0], size)) return false;
+    dataSize = static_cast<std::size_t>(size);
+    return true;
+}
+
+const char* FastCSVParser::dataBegin() const {
+    // Data starts after the header row
+    const char* begin = buffer.data();
+    const void* newline = std::memchr(begin, '\n', dataSize);
+    return newline ? static_cast<const char*>(newline) + 1 : dataEnd();
+}
+
+const char* FastCSVParser::dataEnd() const {
+    return buffer.data() + dataSize;
+}
+
+void FastCSVParser::parseRange(const char* begin, const char* end, std::vector<CSVRow>& rows) const {
+    MaskFunction delimiterMask = delimiterScanner();
+
+    std::string_view fields[kFieldCount];
+    int fieldIndex = 0;
+    const char* fieldStart = begin;
+
+    auto handleDelimiter = [&](const char* pos) {
+        // Fields after the peak column are ignored
+        if (fieldIndex < kFieldCount) fields[fieldIndex++] = std::string_view(fieldStart, pos - fieldStart);
+        fieldStart = pos + 1;
+
+        if (*pos == '\n') {
+            rows.push_back(makeRow(fields));
+            for (std::string_view& field : fields) field = std::string_view();
+            fieldIndex = 0;
+        }
+    };
+
+    const char* block = begin;
+    for (; block + kBlockSize <= end; block += kBlockSize) {
+        for (std::uint64_t mask = delimiterMask(block); mask; mask &= mask - 1) {
+            handleDelimiter(block + countTrailingZeros(mask));
+        }
+    }
+
+    // Last partial block, scanned from a zero-padded copy
+    if (block < end) {
+        char tail[kBlockSize] = {};
+        std::memcpy(tail, block, end - block);
+        for (std::uint64_t mask = delimiterMask(tail); mask; mask &= mask - 1) {
+            handleDelimiter(block + countTrailingZeros(mask));
+        }
+    }
+
+    // Final line without a trailing newline
+    if (fieldStart < end) {
+        if (fieldIndex < kFieldCount) fields[fieldIndex++] = std::string_view(fieldStart, end - fieldStart);
+        rows.push_back(makeRow(fields));
+    }
+}
+
+Order FastCSVParser::toOrder(const CSVRow& row, long long orderNumber) {
+    int side, quantity, peak;
+    double price;
+    if (row.fastNumeric) {
+        side = row.side;
+        quantity = row.quantity;
+        price = row.priceTicks / 100.0;
+        peak = row.peak;
+    }
+    else {
+        // Anything unusual goes through the original conversions (and their exceptions)
+        side = std::stoi(std::string(row.sideField));
+        quantity = std::stoi(std::string(row.quantityField));
+        price = std::stod(std::string(row.priceField));
+        peak = row.peakField.empty() ? 0 : std::stoi(std::string(row.peakField));
+    }
+
+    Order order(orderNumber, row.clientOrder, row.instrument, side, 0, quantity, price, row.client);
+    order.peakQuantity = peak;
+    return order;
+}
+
+void FastCSVParser::parseOrders(std::vector<Order>& orders) const {
+    forEachOrder([&orders](Order& order) {
+        orders.push_back(std::move(order));
+    });
+}
+
+void FastCSVParser::forEachOrder(const std::function<void(Order&)>& consumer) const {
+    std::vector<CSVRow> rows;
+    long long orderCounter = 1;
+
+    // Parse newline-aligned batches so the row array stays small for large files
+    const char* begin = dataBegin();
+    const char* end = dataEnd();
+    while (begin < end) {
+        const char* batchEnd = static_cast<std::size_t>(end - begin) > kBatchBytes ?
+                               nextLineStart(begin + kBatchBytes, end) : end;
+
+        rows.clear();
+        parseRange(begin, batchEnd, rows);
+        for (const CSVRow& row : rows) {
+            Order order = toOrder(row, orderCounter++);
+            consumer(order);
+        }
+        begin = batchEnd;
+    }
+}
+
+void FastCSVParser::parseOrdersParallel(std::vector<Order>& orders, unsigned threads) const {
+    const char* begin = dataBegin();
+    const char* end = dataEnd();
+    if (threads <= 1 || static_cast<std::size_t>(end - begin) < kBatchBytes) {
+        parseOrders(orders);
+        return;
+    }
+
+    // Split the data into newline-aligned chunks of roughly equal size
+    std::vector<const char*> bounds{begin};
+    std::size_t chunkSize = (end - begin) / threads;
+    for (unsigned i = 1; i < threads; ++i) {
+        bounds.push_back(nextLineStart(std::max(begin + chunkSize * i, bounds.back()), end));
+    }
+    bounds.push_back(end);
+
+    std::vector<std::vector<CSVRow>> chunkRows(threads);
+    runParallel(threads, [&](unsigned i) {
+        parseRange(bounds[i], bounds[i + 1], chunkRows[i]);
+    });
+
+    // Prefix sum over chunk line counts gives each chunk its first order number
+    std::vector<long long> firstOrderNumber(threads);
+    long long orderCount = 0;
+    for (unsigned i = 0; i < threads; ++i) {
+        firstOrderNumber[i] = orderCount + 1;
+        orderCount += static_cast<long long>(chunkRows[i].size());
+    }
+
+    // Each chunk builds its orders in place in its own slice, so every order exists once
+    std::size_t firstIndex = orders.size();
+    orders.resize(firstIndex + static_cast<std::size_t>(orderCount), Order(0, {}, {}, 0, 0, 0, 0));
+    runParallel(threads, [&](unsigned i) {
+        Order* slice = orders.data() + firstIndex + (firstOrderNumber[i] - 1);
+        for (std::size_t j = 0; j < chunkRows[i].size(); ++j) {
+            slice[j] = toOrder(chunkRows[i][j], firstOrderNumber[i] + static_cast<long long>(j));
+        }
+        chunkRows[i] = std::vector<CSVRow>();
+    });
+}
@@ -0,0 +1,58 @@
+#ifndef FASTCSVPARSER_H
+#define FASTCSVPARSER_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Order.h"
+
+// One data row of the input CSV: Cl. Ord. ID,Instrument,Side,Quantity,Price[,Client[,Peak]]
+// Text fields point into the parser buffer. When fastNumeric is set the numeric
+// fields were parsed by the fast path, otherwise they are converted with
+// std::stoi/std::stod exactly like the original line-by-line reader.
+struct CSVRow {
+    std::string_view clientOrder;
+    std::string_view instrument;
+    std::string_view sideField;
+    std::string_view quantityField;
+    std::string_view priceField;
+    std::string_view client; // Empty when the optional column is missing
+    std::string_view peakField; // Empty for a plain order
+    int side;
+    int quantity;
+    long long priceTicks; // Price in 1/100 units
+    int peak;
+    bool fastNumeric;
+};
+
+class FastCSVParser {
+public:
+    // Load the whole file into memory. Returns false if the file cannot be read.
+    bool load(const std::string& filename);
+
+    // Parse every data row (the header row is skipped) into orders named ord1, ord2, ...
+    // The orders point into this parser's buffer and must not outlive it
+    void parseOrders(std::vector<Order>& orders) const;
+
+    // Parse every data row in file order and hand each order to consumer as soon as it is built
+    void forEachOrder(const std::function<void(Order&)>& consumer) const;
+
+    // Same result as parseOrders, with newline-aligned chunks parsed on separate threads
+    void parseOrdersParallel(std::vector<Order>& orders, unsigned threads) const;
+
+    // Parse all rows in [begin, end). The range must start at the beginning of a line.
+    void parseRange(const char* begin, const char* end, std::vector<CSVRow>& rows) const;
+
+    // Build the Order for a parsed row with the given arrival number, its text fields view the row
+    static Order toOrder(const CSVRow& row, long long orderNumber);
+
+    const char* dataBegin() const;
+    const char* dataEnd() const;
+
+private:
+    std::string buffer;     // File contents followed by zero padding for block loads
+    std::size_t dataSize = 0;
+};
+
+#endif // FASTCSVPARSER_H
@@ -0,0 +1,189 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+// Reject reasons in MetricsSlot::rejects order, the last slot counts anything else
+const char* const rejectReasons[MetricsSlot::rejectReasonCount - 1] = {
+    "Empty fields", "Invalid instrument", "Invalid quantity", "Invalid peak", "Invalid price", "Invalid side",
+    "Price out of band", "Instrument halted"
+};
+
+const char* const queueStageNames[static_cast<int>(QueueStage::Count)] = {"matching", "reporting"};
+
+int rejectReasonIndex(const char* reason) {
+    for (int i = 0; i < MetricsSlot::rejectReasonCount - 1; ++i) {
+        if (std::strcmp(reason, rejectReasons[i]) == 0) return i;
+    }
+    return MetricsSlot::rejectReasonCount - 1;
+}
+
+// Set for threads that write to the shared overflow slot
+thread_local bool sharedSlot = false;
+
+// Function to add to a counter of the calling thread's slot. An owned slot has a single
+// writer, so the update is a plain load and store without a locked instruction.
+void add(std::atomic<long long>& counter, long long value) {
+    if (sharedSlot) counter.fetch_add(value, std::memory_order_relaxed);
+    else counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+// Sums cover the claimed slots and the overflow slot that follows the last owned slot
+long long sum(std::atomic<long long> MetricsSlot::*counter, int slotCount, const MetricsSlot* slots, const MetricsSlot& overflow) {
+    long long total = (overflow.*counter).load(std::memory_order_relaxed);
+    for (int i = 0; i < slotCount; ++i) total += (slots[i].*counter).load(std::memory_order_relaxed);
+    return total;
+}
+
+template <std::size_t N>
+long long sum(std::atomic<long long> (MetricsSlot::*counters)[N], int index, int slotCount, const MetricsSlot* slots,
+              const MetricsSlot& overflow) {
+    long long total = (overflow.*counters)[index].load(std::memory_order_relaxed);
+    for (int i = 0; i < slotCount; ++i) total += (slots[i].*counters)[index].load(std::memory_order_relaxed);
+    return total;
+}
+
+} // namespace
+
+MetricsSlot Metrics::slots[Metrics::maxSlots + 1];
+std::atomic<int> Metrics::slotCount{0};
+bool Metrics::enabled = false;
+
+// Function to get the calling thread's slot, claimed on first use
+MetricsSlot& Metrics::local() {
+    thread_local MetricsSlot* slot = nullptr;
+    if (!slot) {
+        int index = slotCount.fetch_add(1, std::memory_order_relaxed);
+        // Threads past the limit share the overflow slot and update it with atomic adds
+        if (index >= maxSlots) {
+            index = maxSlots;
+            sharedSlot = true;
+            slotCount.store(maxSlots, std::memory_order_relaxed);
+        }
+        slot = &slots[index];
+    }
+    return *slot;
+}
+
+void Metrics::enable() {
+    enabled = true;
+}
+
+bool Metrics::isEnabled() {
+    return enabled;
+}
+
+void Metrics::recordReport(int status, const char* reason) {
+    if (!enabled) return;
+    MetricsSlot& slot = local();
+    if (status == 1) add(slot.rejects[rejectReasonIndex(reason)], 1);
+    else if (status == 2) add(slot.fills, 1);
+    else if (status == 3) add(slot.partialFills, 1);
+    else if (status == 4) add(slot.cancels, 1);
+}
+
+void Metrics::recordOrderIn() {
+    if (!enabled) return;
+    add(local().ordersIn, 1);
+}
+
+void Metrics::recordResting(int instrument, int change) {
+    if (!enabled || instrument < 0) return;
+    add(local().restingOrders[instrument], change);
+}
+
+void Metrics::recordQueueDepth(QueueStage stage, long long change) {
+    if (!enabled) return;
+    add(local().queueDepth[static_cast<int>(stage)], change);
+}
+
+std::string Metrics::exposition() {
+    int count = std::min(slotCount.load(std::memory_order_relaxed), maxSlots);
+    const MetricsSlot& overflow = slots[maxSlots];
+    std::ostringstream out;
+
+    out << "# HELP flower_orders_in_total Orders received by the matching loop\n"
+        << "# TYPE flower_orders_in_total counter\n"
+        << "flower_orders_in_total " << sum(&MetricsSlot::ordersIn, count, slots, overflow) << "\n";
+
+    out << "# HELP flower_rejects_total Rejected orders by reason\n"
+        << "# TYPE flower_rejects_total counter\n";
+    for (int i = 0; i < MetricsSlot::rejectReasonCount; ++i) {
+        const char* reason = i < MetricsSlot::rejectReasonCount - 1 ? rejectReasons[i] : "Other";
+        out << "flower_rejects_total{reason=\"" << reason << "\"} " << sum(&MetricsSlot::rejects, i, count, slots, overflow) << "\n";
+    }
+
+    out << "# HELP flower_fills_total Fill execution reports\n"
+        << "# TYPE flower_fills_total counter\n"
+        << "flower_fills_total " << sum(&MetricsSlot::fills, count, slots, overflow) << "\n"
+        << "# HELP flower_partial_fills_total Partial fill execution reports\n"
+        << "# TYPE flower_partial_fills_total counter\n"
+        << "flower_partial_fills_total " << sum(&MetricsSlot::partialFills, count, slots, overflow) << "\n"
+        << "# HELP flower_cancels_total Canceled orders\n"
+        << "# TYPE flower_cancels_total counter\n"
+        << "flower_cancels_total " << sum(&MetricsSlot::cancels, count, slots, overflow) << "\n";
+
+    out << "# HELP flower_resting_orders Orders resting in the book by instrument\n"
+        << "# TYPE flower_resting_orders gauge\n";
+    for (int i = 0; i < Order::instrumentCount; ++i) {
+        out << "flower_resting_orders{instrument=\"" << Order::instrumentNames[i] << "\"} "
+            << sum(&MetricsSlot::restingOrders, i, count, slots, overflow) << "\n";
+    }
+
+    out << "# HELP flower_queue_depth Items waiting in each stage queue\n"
+        << "# TYPE flower_queue_depth gauge\n";
+    for (int i = 0; i < static_cast<int>(QueueStage::Count); ++i) {
+        out << "flower_queue_depth{stage=\"" << queueStageNames[i] << "\"} "
+            << sum(&MetricsSlot::queueDepth, i, count, slots, overflow) << "\n";
+    }
+    return out.str();
+}
+
+MetricsExporter::MetricsExporter(const std::string& filename, int intervalMs)
+    : filename(filename), intervalMs(intervalMs) {
+    thread = std::thread(&MetricsExporter::run, this);
+}
+
+MetricsExporter::~MetricsExporter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_one();
+    thread.join();
+    writeSnapshot();
+}
+
+// Function to replace the metrics file in one step so readers never see a partial file
+void MetricsExporter::writeSnapshot() {
+    std::string temporary = filename + ".tmp";
+    {
+        std::ofstream file(temporary);
+        if (!file.is_open()) {
+            std::cerr << "Error opening file: " << temporary << std::endl;
+            return;
+        }
+        file << Metrics::exposition();
+    }
+#if defined(_WIN32)
+    std::remove(filename.c_str());
+#endif
+    std::rename(temporary.c_str(), filename.c_str());
+}
+
+void MetricsExporter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        wakeUp.wait_for(lock, std::chrono::milliseconds(intervalMs));
+        if (stopping) break;
+        lock.unlock();
+        writeSnapshot();
+        lock.lock();
+    }
+}
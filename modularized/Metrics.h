@@ -0,0 +1,76 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Order.h"
+
+// Inter-stage queues whose depth is exported
+enum class QueueStage {
+    Matching,  // Parsed orders waiting for the matching loop
+    Reporting, // Execution report rows waiting for the reporting thread
+    Count
+};
+
+// Counters owned by one thread. Each slot sits on its own cache lines so
+// threads never write to a shared line; readers sum the slots without locks.
+// The owner updates its counters with plain relaxed loads and stores, only the
+// shared overflow slot used by threads past the slot limit needs atomic adds.
+struct alignas(64) MetricsSlot {
+    static const int rejectReasonCount = 9; // Known reasons plus "Other"
+
+    std::atomic<long long> ordersIn{0};
+    std::atomic<long long> rejects[rejectReasonCount] = {};
+    std::atomic<long long> fills{0};
+    std::atomic<long long> partialFills{0};
+    std::atomic<long long> cancels{0};
+    std::atomic<long long> restingOrders[Order::instrumentCount] = {}; // Change in depth made by this thread
+    std::atomic<long long> queueDepth[static_cast<int>(QueueStage::Count)] = {};
+};
+
+class Metrics {
+private:
+    static const int maxSlots = 256;
+    static MetricsSlot slots[maxSlots + 1]; // Owned slots, then the shared overflow slot
+    static std::atomic<int> slotCount;
+    static bool enabled;
+
+    static MetricsSlot& local();
+
+public:
+    // Turn counting on; call before the engine threads start
+    static void enable();
+    static bool isEnabled();
+
+    // Count an execution report row by status (reject, fill, partial fill, cancel)
+    static void recordReport(int status, const char* reason);
+    static void recordOrderIn();
+    static void recordResting(int instrument, int change); // instrument is an Order::instrumentIndex()
+    static void recordQueueDepth(QueueStage stage, long long change);
+
+    // All counters summed over every thread, in Prometheus text exposition format
+    static std::string exposition();
+};
+
+// Writes the metrics exposition to a file on a background thread
+class MetricsExporter {
+private:
+    std::string filename;
+    int intervalMs;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    bool stopping = false;
+
+    void writeSnapshot();
+    void run();
+
+public:
+    MetricsExporter(const std::string& filename, int intervalMs);
+    ~MetricsExporter(); // Writes a final snapshot
+};
+
+#endif // METRICS_H
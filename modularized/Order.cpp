@@ -1,10 +1,16 @@
 #include "Order.h"
 #include <iostream>
 
-Order::Order(const std::string& ord, const std::string& clientOrder, const std::string& instrument, int side,
-             int status, int quantity, double price)
-    : ord(ord), clientOrder(clientOrder), instrument(instrument), side(side), 
-      status(status), quantity(quantity), price(price) {}
+const char* const Order::instrumentNames[Order::instrumentCount] = {"Rose", "Lavender", "Lotus", "Tulip", "Orchid"};
+
+Order::Order(long long orderNumber, std::string_view clientOrder, std::string_view instrument, int side,
+             int status, int quantity, double price, std::string_view client)
+    : orderNumber(orderNumber), clientOrder(clientOrder), instrument(instrument), side(side), 
+      status(status), quantity(quantity), price(price), client(client), instrumentId(-1) {
+    for (int i = 0; i < instrumentCount; ++i) {
+        if (instrument == instrumentNames[i]) instrumentId = i;
+    }
+}
 
 bool Order::isBuyOrder() const {
     return side == 1;
@@ -14,19 +20,31 @@ bool Order::isSellOrder() const {
     return side == 2;
 }
 
-std::pair<bool, std::string> Order::isValid() const {
+bool Order::isIceberg() const {
+    return peakQuantity != 0;
+}
+
+int Order::instrumentIndex() const {
+    return instrumentId;
+}
+
+std::pair<bool, const char*> Order::isValid() const {
     bool nonempty_fields = !clientOrder.empty() && !instrument.empty();
-    bool valid_quantity = quantity % 10 == 0 && quantity >= 10 && quantity < 1000; // Exclude endpoints
+    int max_quantity = isIceberg() ? maxIcebergQuantity : 1000;
+    bool valid_quantity = quantity % 10 == 0 && quantity >= 10 && quantity < max_quantity; // Exclude endpoints
+    bool valid_peak = !isIceberg() ||
+                      (peakQuantity % 10 == 0 && peakQuantity >= 10 && peakQuantity < 1000 && peakQuantity <= quantity);
     bool valid_price = price > 0;
     bool valid_side = side == 1 || side == 2;
-    bool valid_instrument = instrument == "Rose" || instrument == "Lavender" || instrument == "Lotus" || instrument == "Tulip" || instrument == "Orchid";  
+    bool valid_instrument = instrumentIndex() >= 0;
 
-    bool is_valid = nonempty_fields && valid_quantity && valid_price && valid_side && valid_instrument;
+    bool is_valid = nonempty_fields && valid_quantity && valid_peak && valid_price && valid_side && valid_instrument;
 
-    std::string reason = "";
+    const char* reason = "";
     if (!nonempty_fields) reason = "Empty fields";
     else if (!valid_instrument) reason = "Invalid instrument";
     else if (!valid_quantity) reason = "Invalid quantity";
+    else if (!valid_peak) reason = "Invalid peak";
     else if (!valid_price) reason = "Invalid price";
     else if (!valid_side) reason = "Invalid side";
 
@@ -34,7 +52,7 @@ std::pair<bool, std::string> Order::isValid() const {
 }
 
 bool Order::operator==(const Order& other) const {
-    return ord == other.ord && 
+    return orderNumber == other.orderNumber && 
            clientOrder == other.clientOrder &&
            instrument == other.instrument && 
            side == other.side &&
@@ -43,15 +61,17 @@ bool Order::operator==(const Order& other) const {
 }
 
 void Order::printOrder() const {
-    std::cout << "Order ID: " << ord
+    std::cout << "Order ID: ord" << orderNumber
               << ", Client Order: " << clientOrder
               << ", Instrument: " << instrument
               << ", Side: " << side
               << ", Status: " << (status == 0 ? "New" :
                                   status == 1 ? "Rejected" :
                                   status == 2 ? "Fill" :
-                                  status == 3 ? "Pfill" : "Unknown")
+                                  status == 3 ? "Pfill" :
+                                  status == 4 ? "Canceled" : "Unknown")
               << ", Quantity: " << quantity
-              << ", Price: " << price
-              << std::endl;
+              << ", Price: " << price;
+    if (isIceberg()) std::cout << ", Hidden: " << hiddenQuantity;
+    std::cout << std::endl;
 }
\ No newline at end of file
@@ -1,25 +1,43 @@
 #ifndef ORDER_H
 #define ORDER_H
 
-#include <string>
+#include <string_view>
 #include <utility>
 
+// Text fields point into the loaded input file, which outlives its orders, so copying an
+// order never allocates
 class Order {
 public:
-    std::string ord;
-    std::string clientOrder;
-    std::string instrument;
+    long long orderNumber; // Reported as ord<orderNumber>
+    std::string_view clientOrder;
+    std::string_view instrument;
     int side;
     int status;
     int quantity;
     double price;
+    std::string_view client; // Owning client/account, empty when not given
+    int clientId = 0;   // Interned client, 0 when there is no client
+    int peakQuantity = 0;   // Displayed quantity of an iceberg order, 0 for a plain order
+    int hiddenQuantity = 0; // Iceberg reserve not yet displayed in the book
+    long long sequence = 0; // Time priority within a price level, set when the order enters the book
+    int clientLink = -1;    // Entry in the order book's per-client index, -1 when not indexed
+    int instrumentId;       // Index into instrumentNames, -1 for an unknown instrument
 
-    Order(const std::string& ord, const std::string& clientOrder, const std::string& instrument, int side,
-          int status, int quantity, double price);
+    // Tradable instruments, in instrumentIndex() order
+    static const int instrumentCount = 5;
+    static const char* const instrumentNames[instrumentCount];
+
+    // Total quantity limit of an iceberg order, its peak follows the plain order limits
+    static const int maxIcebergQuantity = 100000;
+
+    Order(long long orderNumber, std::string_view clientOrder, std::string_view instrument, int side,
+          int status, int quantity, double price, std::string_view client = std::string_view());
 
     bool isBuyOrder() const;
     bool isSellOrder() const;
-    std::pair<bool, std::string> isValid() const;
+    bool isIceberg() const;
+    int instrumentIndex() const; // -1 for an unknown instrument, looked up once at construction
+    std::pair<bool, const char*> isValid() const;
     bool operator==(const Order& other) const;
     void printOrder() const;
 };
@@ -1,34 +1,423 @@
 #include "OrderBook.h"
+#include "Metrics.h"
 #include <algorithm>
+#include <cstdlib>
 #include <iostream>
 
-OrderBook::OrderBook(CSVHandler& handler, const std::string& inputFile, const std::string& outputFile)
-    : csvHandler(handler), inputFilename(inputFile), outputFilename(outputFile) {}
+OrderBook::OrderBook(CSVHandler& handler, const std::string& inputFile, const std::string& outputFile,
+                     const EngineConfig& config)
+    : csvHandler(handler), inputFilename(inputFile), outputFilename(outputFile), trace(config.trace),
+      selfTradePrevention(config.selfTradePrevention),
+      priceBandsEnabled(config.priceBand > 0 || config.haltMove > 0),
+      priceBands(config.priceBand, config.haltMove, config.haltOrders, config.referencePrices), auctionsEnabled(config.auctionOrders > 0) {}
 
-void OrderBook::sortOrderbook() {
-    std::cout << "Sorting the orderbook" << std::endl;
+// Function to preallocate the book so matching never grows it
+void OrderBook::reserve(std::size_t buyCount, std::size_t sellCount, int clientCount) {
+    buyOrders.reserve(buyCount);
+    sellOrders.reserve(sellCount);
+    clientLinks.reserve(buyCount + sellCount);
+    clientPositions.reserve(std::max(buyCount, sellCount));
+    if (clientCount + 1 > static_cast<int>(clientHeads.size())) {
+        clientHeads.resize(clientCount + 1, -1);
+    }
+    if (auctionsEnabled) {
+        auctionPrices.reserve(buyCount + sellCount);
+        buyDepth.reserve(buyCount + sellCount);
+        sellDepth.reserve(buyCount + sellCount);
+        auctionReports.reserve(buyCount + sellCount);
+    }
+}
+
+// Price-time priority of each side of the book
+static bool buyPriority(const Order& a, const Order& b) {
+    if (a.price != b.price) return a.price > b.price;
+    else return a.sequence < b.sequence;
+}
+
+static bool sellPriority(const Order& a, const Order& b) {
+    if (a.price != b.price) return a.price < b.price;
+    else return a.sequence < b.sequence;
+}
+
+// Function to add an order to one side of the book and to its client's index.
+// The order is inserted behind every order at its price, so the book stays sorted.
+// During a call phase it is appended instead and the book is sorted at the uncross.
+void OrderBook::addRestingOrder(std::vector<Order>& orders, const Order& order) {
+    bool buySide = &orders == &buyOrders;
+    auto position = callPhase ? orders.end() :
+        std::upper_bound(orders.begin(), orders.end(), order.price, [buySide](double price, const Order& other) {
+            return buySide ? price > other.price : price < other.price;
+        });
+    Order& resting_order = *orders.insert(position, order);
+    resting_order.sequence = nextSequence++;
+
+    // An iceberg only displays its peak, the rest is held in reserve
+    if (resting_order.isIceberg()) {
+        int total = resting_order.quantity + resting_order.hiddenQuantity;
+        resting_order.quantity = std::min(resting_order.peakQuantity, total);
+        resting_order.hiddenQuantity = total - resting_order.quantity;
+    }
+
+    Metrics::recordResting(order.instrumentIndex(), 1);
+    if (priceBandsEnabled) priceBands.recordResting(resting_order);
+    if (order.clientId != 0) resting_order.clientLink = linkClientOrder(resting_order, buySide);
+}
+
+// Function to add a resting order to the front of its client's list, returns its link
+int OrderBook::linkClientOrder(const Order& order, bool buySide) {
+    if (order.clientId >= static_cast<int>(clientHeads.size())) clientHeads.resize(order.clientId + 1, -1);
+
+    int link = freeClientLink;
+    if (link >= 0) {
+        freeClientLink = clientLinks[link].next;
+    }
+    else {
+        link = static_cast<int>(clientLinks.size());
+        clientLinks.emplace_back();
+    }
+
+    int& head = clientHeads[order.clientId];
+    clientLinks[link] = {order.price, order.sequence, order.clientId, buySide, -1, head};
+    if (head >= 0) clientLinks[head].prev = link;
+    head = link;
+    return link;
+}
+
+// Function to remove a link from its client's list and return it to the free list
+void OrderBook::unlinkClientOrder(int link) {
+    ClientOrderLink& entry = clientLinks[link];
+    if (entry.prev >= 0) clientLinks[entry.prev].next = entry.next;
+    else clientHeads[entry.clientId] = entry.next;
+    if (entry.next >= 0) clientLinks[entry.next].prev = entry.prev;
+
+    entry.next = freeClientLink;
+    freeClientLink = link;
+}
+
+// Function to remove a resting order, returns the iterator to the next order
+std::vector<Order>::iterator OrderBook::removeRestingOrder(std::vector<Order>& orders, std::vector<Order>::iterator it) {
+    if (it->clientLink >= 0) unlinkClientOrder(it->clientLink);
+    Metrics::recordResting(it->instrumentIndex(), -1);
+    return orders.erase(it);
+}
+
+// Function to display the next peak of an iceberg whose displayed quantity has traded. The order loses its
+// time priority and moves behind the other orders at its price. Returns the iterator to the next order.
+std::vector<Order>::iterator OrderBook::replenishIceberg(std::vector<Order>& orders, std::vector<Order>::iterator it) {
+    it->quantity = std::min(it->peakQuantity, it->hiddenQuantity);
+    it->hiddenQuantity -= it->quantity;
+    it->sequence = nextSequence++;
+    if (it->clientLink >= 0) clientLinks[it->clientLink].sequence = it->sequence;
+
+    auto levelEnd = it + 1;
+    while (levelEnd != orders.end() && levelEnd->price == it->price) ++levelEnd;
+    std::rotate(it, it + 1, levelEnd);
+    return it;
+}
+
+// Function to trade the input order against the resting order at it and write both execution reports.
+// Returns the iterator to the next resting order to consider.
+std::vector<Order>::iterator OrderBook::executeMatch(Order& input_order, Order& processed_order,
+                                                     std::vector<Order>& restingOrders, std::vector<Order>::iterator it) {
+    Order& resting_order = *it;
+    int quantity = std::min(input_order.quantity, resting_order.quantity);
+    int resting_left = resting_order.quantity - quantity;
+
+    processed_order.status = input_order.quantity == quantity ? 2 : 3;
+    processed_order.quantity = quantity;
+    processed_order.price = resting_order.price;
+    input_order.quantity -= quantity;
 
-    std::sort(buyOrders.begin(), buyOrders.end(), [](const Order& a, const Order& b) {
-        if (a.price != b.price) return a.price > b.price;
-        else return a.ord < b.ord;
-    });
+    // Both reports carry the traded quantity, an iceberg stays partially filled while it has a reserve
+    resting_order.status = resting_left == 0 && resting_order.hiddenQuantity == 0 ? 2 : 3;
+    resting_order.quantity = quantity;
+    csvHandler.writeOrderToCSV(outputFilename, processed_order);
+    csvHandler.writeOrderToCSV(outputFilename, resting_order);
+    resting_order.quantity = resting_left;
 
-    std::sort(sellOrders.begin(), sellOrders.end(), [](const Order& a, const Order& b) {
-        if (a.price != b.price) return a.price < b.price;
-        else return a.ord < b.ord;
-    });
+    if (resting_left > 0) return it + 1;
+    if (resting_order.hiddenQuantity > 0) return replenishIceberg(restingOrders, it);
+    return removeRestingOrder(restingOrders, it);
+}
+
+// Function to report a canceled order, an iceberg also cancels its hidden reserve
+void OrderBook::reportCanceled(Order& order, const char* reason) {
+    order.status = 4;
+    order.quantity += order.hiddenQuantity;
+    order.hiddenQuantity = 0;
+    csvHandler.writeOrderToCSV(outputFilename, order, reason);
+}
+
+// Function to apply self-trade prevention between an incoming order and a resting order of the same client.
+// Advances it past the resting order unless the incoming order is canceled. Returns true if it was canceled.
+bool OrderBook::preventSelfTrade(Order& input_order, std::vector<Order>& restingOrders, std::vector<Order>::iterator& it) {
+    if (trace) std::cout << "Self-trade prevented" << std::endl;
+    const char* reason = "Self-trade prevention";
+    Order& resting_order = *it;
+
+    switch (selfTradePrevention) {
+    case SelfTradePrevention::CancelNewest:
+        reportCanceled(input_order, reason);
+        return true;
+
+    case SelfTradePrevention::CancelOldest:
+        reportCanceled(resting_order, reason);
+        it = removeRestingOrder(restingOrders, it);
+        return false;
+
+    case SelfTradePrevention::Decrement: {
+        // Both orders shrink by the smaller total quantity, the smaller one is canceled.
+        // An iceberg counts its reserve and displays its next peak once the displayed part is used up.
+        int resting_total = resting_order.quantity + resting_order.hiddenQuantity;
+        int quantity = std::min(input_order.quantity, resting_total);
+        bool input_canceled = input_order.quantity == quantity;
+        bool resting_canceled = resting_total == quantity;
+
+        if (resting_canceled) {
+            reportCanceled(resting_order, reason);
+            it = removeRestingOrder(restingOrders, it);
+        }
+        else {
+            int displayed = std::min(quantity, resting_order.quantity);
+            resting_order.quantity -= displayed;
+            resting_order.hiddenQuantity -= quantity - displayed;
+            if (resting_order.quantity > 0) ++it;
+            else it = replenishIceberg(restingOrders, it);
+        }
+
+        if (input_canceled) {
+            reportCanceled(input_order, reason);
+        }
+        else {
+            input_order.quantity -= quantity;
+        }
+        return input_canceled;
+    }
+
+    default:
+        ++it;
+        return false;
+    }
+}
+
+// Function to cancel every resting order of a client, e.g. when the client disconnects.
+// Only the client's own orders are visited. They are left in the book with no quantity
+// and compacted out in one pass before the book is used again.
+void OrderBook::cancelClientOrders(int clientId, const char* reason) {
+    if (clientId <= 0 || clientId >= static_cast<int>(clientHeads.size()) || clientHeads[clientId] < 0) return;
+
+    // Orders collected during a call phase are unsorted until the uncross
+    if (callPhase) sortOrderbook();
+
+    for (bool buySide : {true, false}) {
+        std::vector<Order>& orders = buySide ? buyOrders : sellOrders;
+        clientPositions.clear();
+        for (int link = clientHeads[clientId]; link >= 0; link = clientLinks[link].next) {
+            const ClientOrderLink& entry = clientLinks[link];
+            if (entry.buySide != buySide) continue;
+            auto it = std::lower_bound(orders.begin(), orders.end(), entry,
+                                       [buySide](const Order& order, const ClientOrderLink& key) {
+                if (order.price != key.price) return buySide ? order.price > key.price : order.price < key.price;
+                else return order.sequence < key.sequence;
+            });
+            clientPositions.push_back(it - orders.begin());
+        }
+
+        // Reported in priority order like the rest of the book
+        std::sort(clientPositions.begin(), clientPositions.end());
+        for (std::size_t position : clientPositions) {
+            Order& order = orders[position];
+            reportCanceled(order, reason);
+            Metrics::recordResting(order.instrumentIndex(), -1);
+            order.quantity = 0;
+            order.clientLink = -1;
+        }
+        canceledInBook += static_cast<long long>(clientPositions.size());
+    }
+
+    while (clientHeads[clientId] >= 0) unlinkClientOrder(clientHeads[clientId]);
+}
+
+// Function to drop the orders cancelClientOrders left in the book, keeping the others in priority order
+void OrderBook::removeCanceledOrders() {
+    if (canceledInBook == 0) return;
+    for (std::vector<Order>* orders : {&buyOrders, &sellOrders}) {
+        orders->erase(std::remove_if(orders->begin(), orders->end(), [](const Order& order) {
+            return order.quantity == 0;
+        }), orders->end());
+    }
+    canceledInBook = 0;
+}
+
+// Function to start a call phase, orders rest without matching until uncross is called
+void OrderBook::beginAuction() {
+    if (trace) std::cout << "Call auction started" << std::endl;
+    callPhase = true;
+}
+
+bool OrderBook::inAuction() const {
+    return callPhase;
+}
+
+// Function to end the call phase by executing every instrument at its equilibrium price
+void OrderBook::uncross() {
+    if (trace) std::cout << "Uncrossing the orderbook" << std::endl;
+    callPhase = false;
+    removeCanceledOrders();
+
+    // Orders collected during the call phase were appended unsorted
+    sortOrderbook();
+
+    auctionReports.clear();
+    for (int instrument = 0; instrument < Order::instrumentCount; ++instrument) {
+        uncrossInstrument(instrument);
+    }
+    csvHandler.writeOrdersToCSV(outputFilename, auctionReports);
+
+    removeFilledOrders(buyOrders);
+    removeFilledOrders(sellOrders);
+    if (trace) printOrderbook();
+}
+
+// Function to find the price that executes the most volume for one instrument and execute it.
+// Ties go to the smallest surplus, then the lowest price, or the highest price when buyers are left over.
+void OrderBook::uncrossInstrument(int instrument) {
+    const char* name = Order::instrumentNames[instrument];
+
+    auctionPrices.clear();
+    for (const std::vector<Order>* orders : {&buyOrders, &sellOrders}) {
+        for (const Order& order : *orders) {
+            if (order.instrumentId == instrument) auctionPrices.push_back(order.price);
+        }
+    }
+    std::sort(auctionPrices.begin(), auctionPrices.end());
+    auctionPrices.erase(std::unique(auctionPrices.begin(), auctionPrices.end()), auctionPrices.end());
+    if (auctionPrices.empty()) return;
+
+    // Quantity at each price level, then cumulated from the aggressive end of each side
+    std::size_t levels = auctionPrices.size();
+    buyDepth.assign(levels, 0);
+    sellDepth.assign(levels, 0);
+    for (const Order& order : buyOrders) {
+        if (order.instrumentId != instrument) continue;
+        auto level = std::lower_bound(auctionPrices.begin(), auctionPrices.end(), order.price) - auctionPrices.begin();
+        buyDepth[level] += order.quantity + order.hiddenQuantity;
+    }
+    for (const Order& order : sellOrders) {
+        if (order.instrumentId != instrument) continue;
+        auto level = std::lower_bound(auctionPrices.begin(), auctionPrices.end(), order.price) - auctionPrices.begin();
+        sellDepth[level] += order.quantity + order.hiddenQuantity;
+    }
+    for (std::size_t i = levels - 1; i > 0; --i) buyDepth[i - 1] += buyDepth[i];
+    for (std::size_t i = 1; i < levels; ++i) sellDepth[i] += sellDepth[i - 1];
+
+    std::size_t best = 0;
+    long long bestVolume = 0;
+    long long bestSurplus = 0;
+    for (std::size_t i = 0; i < levels; ++i) {
+        long long volume = std::min(buyDepth[i], sellDepth[i]);
+        long long surplus = std::llabs(buyDepth[i] - sellDepth[i]);
+        if (volume > bestVolume || (volume == bestVolume && volume > 0 &&
+            (surplus < bestSurplus || (surplus == bestSurplus && buyDepth[i] > sellDepth[i])))) {
+            best = i;
+            bestVolume = volume;
+            bestSurplus = surplus;
+        }
+    }
+    if (bestVolume == 0) return;
+
+    double price = auctionPrices[best];
+    if (trace) std::cout << "Uncrossing " << name << " at " << price << " for " << bestVolume << std::endl;
+
+    // Both sides are in price-time priority, so the volume goes to the best priced and oldest orders
+    long long buyLeft = bestVolume;
+    for (Order& order : buyOrders) {
+        if (buyLeft == 0 || order.price < price) break;
+        if (order.instrumentId == instrument) buyLeft -= executeAuctionOrder(order, price, buyLeft);
+    }
+    long long sellLeft = bestVolume;
+    for (Order& order : sellOrders) {
+        if (sellLeft == 0 || order.price > price) break;
+        if (order.instrumentId == instrument) sellLeft -= executeAuctionOrder(order, price, sellLeft);
+    }
+
+    // The uncross leaves nothing crossed, a halt only rejects the instrument's next orders
+    if (priceBandsEnabled && priceBands.recordTrade(instrument, price)) {
+        if (trace) std::cout << "Instrument halted by the uncross of " << name << std::endl;
+    }
+}
+
+// Function to execute up to volumeLeft of an order at the auction price and queue its report.
+// Returns the executed quantity, an order left with nothing is removed after the uncross.
+long long OrderBook::executeAuctionOrder(Order& order, double price, long long volumeLeft) {
+    int total = order.quantity + order.hiddenQuantity;
+    int executed = static_cast<int>(std::min<long long>(total, volumeLeft));
+    int remaining = total - executed;
+
+    auctionReports.push_back(order);
+    Order& report = auctionReports.back();
+    report.status = remaining == 0 ? 2 : 3;
+    report.quantity = executed;
+    report.price = price;
+
+    // An iceberg displays its next peak from what is left
+    order.status = 3;
+    order.quantity = order.isIceberg() ? std::min(order.peakQuantity, remaining) : remaining;
+    order.hiddenQuantity = remaining - order.quantity;
+    return executed;
+}
+
+// Function to drop the orders an uncross executed completely, keeping the others in priority order
+void OrderBook::removeFilledOrders(std::vector<Order>& orders) {
+    for (const Order& order : orders) {
+        if (order.quantity != 0) continue;
+        if (order.clientLink >= 0) unlinkClientOrder(order.clientLink);
+        Metrics::recordResting(order.instrumentIndex(), -1);
+    }
+    orders.erase(std::remove_if(orders.begin(), orders.end(), [](const Order& order) {
+        return order.quantity == 0;
+    }), orders.end());
+}
+
+void OrderBook::sortOrderbook() {
+    if (trace) std::cout << "Sorting the orderbook" << std::endl;
+
+    std::sort(buyOrders.begin(), buyOrders.end(), buyPriority);
+    std::sort(sellOrders.begin(), sellOrders.end(), sellPriority);
 }
 
 void OrderBook::processOrder(Order& input_order) {
-    std::cout << "Now considering: " << input_order.ord << std::endl;
+    if (trace) std::cout << "Now considering: ord" << input_order.orderNumber << std::endl;
+    removeCanceledOrders();
 
     bool isMatching = false;
     bool input_order_filled = false;
+    bool input_order_canceled = false;
+    bool instrument_halted = false;
+
+    // Reject orders outside the instrument's price band or during a halt
+    if (priceBandsEnabled) {
+        if (const char* reason = priceBands.check(input_order)) {
+            if (trace) std::cout << reason << std::endl;
+            input_order.status = 1;
+            csvHandler.writeOrderToCSV(outputFilename, input_order, reason);
+            return;
+        }
+    }
+
+    // During a call phase orders only rest, they are matched at the uncross
+    if (callPhase) {
+        if (input_order.isBuyOrder()) addRestingOrder(buyOrders, input_order);
+        else if (input_order.isSellOrder()) addRestingOrder(sellOrders, input_order);
+        csvHandler.writeOrderToCSV(outputFilename, input_order);
+        return;
+    }
+
     Order processed_order = input_order;
     double input_order_price = input_order.price;
 
     if (input_order.isBuyOrder()) {
-        std::cout << "This is a buy order" << std::endl;
+        if (trace) std::cout << "This is a buy order" << std::endl;
 
         auto it = sellOrders.begin();
         while (it != sellOrders.end()) {
@@ -36,49 +425,36 @@ void OrderBook::processOrder(Order& input_order) {
 
             if (input_order_price < sell_order.price) break;
 
-            if (input_order.instrument == sell_order.instrument && input_order.price >= sell_order.price) { // change for largeer sell orders
-                std::cout << "Matching orders found" << std::endl;
+            if (input_order.instrumentId == sell_order.instrumentId && input_order.price >= sell_order.price) { // change for largeer sell orders
+                if (selfTradePrevention != SelfTradePrevention::None && input_order.clientId != 0 &&
+                    input_order.clientId == sell_order.clientId) {
+                    input_order_canceled = preventSelfTrade(input_order, sellOrders, it);
+                    if (input_order_canceled) break;
+                    continue;
+                }
+
+                if (trace) std::cout << "Matching orders found" << std::endl;
                 isMatching = true;
 
-                if (input_order.quantity == sell_order.quantity) {
-                    processed_order.status = 2;
-                    sell_order.status = 2;
-                    processed_order.price = sell_order.price;
-                    input_order_filled = true;
-                } 
-                else if (input_order.quantity > sell_order.quantity) {
-                    processed_order.status = 3;
-                    sell_order.status = 2;
-                    processed_order.quantity = sell_order.quantity;
-                    input_order.quantity = input_order.quantity - sell_order.quantity;
-                    processed_order.price = sell_order.price;
-                }
-                else if (input_order.quantity < sell_order.quantity) { // Changed for larger sell orders
-                    processed_order.status = 2;
-                    sell_order.status = 3;
-                    sell_order.quantity = sell_order.quantity - input_order.quantity;
-                    processed_order.quantity = input_order.quantity;
-                    processed_order.price = sell_order.price;
-                } 
-
-                csvHandler.writeOrderToCSV(outputFilename, processed_order);
-                csvHandler.writeOrderToCSV(outputFilename, sell_order);
-
-                it = sellOrders.erase(it);
+                it = executeMatch(input_order, processed_order, sellOrders, it);
+                input_order_filled = input_order.quantity == 0;
+
+                // A halting trade stops the sweep, the rest of the order is canceled below
+                if (priceBandsEnabled) instrument_halted = priceBands.recordTrade(input_order.instrumentIndex(), processed_order.price);
             } else {
                 ++it;
             }
 
-            if (input_order_filled) break;
+            if (input_order_filled || instrument_halted) break;
         }
 
-        if (!isMatching) {
-            std::cout << "No matching orders" << std::endl;
-            buyOrders.push_back(input_order);
+        if (!isMatching && !input_order_canceled) {
+            if (trace) std::cout << "No matching orders" << std::endl;
+            addRestingOrder(buyOrders, input_order);
             csvHandler.writeOrderToCSV(outputFilename, input_order);
         }
     } else if (input_order.isSellOrder()) {
-        std::cout << "This is a sell order" << std::endl;
+        if (trace) std::cout << "This is a sell order" << std::endl;
 
         auto it = buyOrders.begin();
         while (it != buyOrders.end()) {
@@ -86,61 +462,55 @@ void OrderBook::processOrder(Order& input_order) {
 
             if (input_order_price > buy_order.price) break;
 
-            if (input_order.instrument == buy_order.instrument && input_order.price <= buy_order.price) { // Changed for larger buy orders
-                std::cout << "Matching orders found" << std::endl;
+            if (input_order.instrumentId == buy_order.instrumentId && input_order.price <= buy_order.price) { // Changed for larger buy orders
+                if (selfTradePrevention != SelfTradePrevention::None && input_order.clientId != 0 &&
+                    input_order.clientId == buy_order.clientId) {
+                    input_order_canceled = preventSelfTrade(input_order, buyOrders, it);
+                    if (input_order_canceled) break;
+                    continue;
+                }
+
+                if (trace) std::cout << "Matching orders found" << std::endl;
                 isMatching = true;
 
-                if (input_order.quantity > buy_order.quantity) {
-                    processed_order.status = 3;
-                    buy_order.status = 2;
-                    input_order.quantity = input_order.quantity - buy_order.quantity;
-                    processed_order.quantity = buy_order.quantity;
-                    processed_order.price = buy_order.price;
-                } 
-                else if (input_order.quantity == buy_order.quantity) {
-                    processed_order.status = 2;
-                    buy_order.status = 2;
-                    processed_order.price = buy_order.price;
-                    input_order_filled = true;
-                }
-                else if (input_order.quantity < buy_order.quantity) { // Changed for larger buy orders
-                    processed_order.status = 2;
-                    buy_order.status = 3;
-                    buy_order.quantity = buy_order.quantity - input_order.quantity;
-                    processed_order.quantity = input_order.quantity;
-                    processed_order.price = buy_order.price;
-                } 
-
-                csvHandler.writeOrderToCSV(outputFilename, processed_order);
-                csvHandler.writeOrderToCSV(outputFilename, buy_order);
-
-                it = buyOrders.erase(it);
+                it = executeMatch(input_order, processed_order, buyOrders, it);
+                input_order_filled = input_order.quantity == 0;
+
+                // A halting trade stops the sweep, the rest of the order is canceled below
+                if (priceBandsEnabled) instrument_halted = priceBands.recordTrade(input_order.instrumentIndex(), processed_order.price);
             } else {
                 ++it;
             }
 
-            if (input_order_filled) break;
+            if (input_order_filled || instrument_halted) break;
         }
 
-        if (!isMatching) {
-            std::cout << "No matching orders" << std::endl;
-            sellOrders.push_back(input_order);
+        if (!isMatching && !input_order_canceled) {
+            if (trace) std::cout << "No matching orders" << std::endl;
+            addRestingOrder(sellOrders, input_order);
             csvHandler.writeOrderToCSV(outputFilename, input_order);
         }
     }
 
-    if (isMatching && processed_order.status == 3) {
+    // The rest of an order whose trade halted the instrument is canceled, resting it
+    // at its original price would leave it crossed with the other side of the book
+    if (isMatching && !input_order_canceled && processed_order.status == 3 && instrument_halted) {
+        if (trace) std::cout << "Instrument halted, canceling the rest of the order" << std::endl;
+        reportCanceled(input_order, "Instrument halted");
+    }
+    else if (isMatching && !input_order_canceled && processed_order.status == 3) {
         input_order.status = 3;
 
-        if (input_order.isBuyOrder()) buyOrders.push_back(input_order);
-        else if (input_order.isSellOrder()) sellOrders.push_back(input_order);
+        if (input_order.isBuyOrder()) addRestingOrder(buyOrders, input_order);
+        else if (input_order.isSellOrder()) addRestingOrder(sellOrders, input_order);
     }
 
-    sortOrderbook();
-    printOrderbook();
+    if (trace) printOrderbook();
 }
 
 void OrderBook::printOrderbook() {
+    removeCanceledOrders();
+
     std::cout << "Printing the BUY side" << std::endl;
     std::cout << "---------------------" << std::endl;
     for (const Order& order : buyOrders) {
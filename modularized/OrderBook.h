@@ -4,6 +4,19 @@
 #include <vector>
 #include "Order.h"
 #include "CSVHandler.h"
+#include "EngineConfig.h"
+#include "PriceBandMonitor.h"
+
+// One resting order in its client's list. The order is found again by binary search on its price and
+// time priority, which stay fixed while it rests (an iceberg refresh updates the sequence here too).
+struct ClientOrderLink {
+    double price;
+    long long sequence;
+    int clientId;
+    bool buySide;
+    int prev;
+    int next; // Next order of the same client, or the next free link
+};
 
 class OrderBook {
 private:
@@ -12,12 +25,48 @@ private:
     CSVHandler& csvHandler;
     std::string inputFilename;
     std::string outputFilename;
+    bool trace; // Print each step and the book after every order to stdout
+    SelfTradePrevention selfTradePrevention;
+    std::vector<ClientOrderLink> clientLinks; // Per-client lists of resting orders, freed links are reused
+    std::vector<int> clientHeads;             // First link of each client id, -1 when it has no resting order
+    int freeClientLink = -1;
+    std::vector<std::size_t> clientPositions; // Scratch space for one client's book positions
+    long long canceledInBook = 0;             // Mass-canceled orders not yet compacted out of the book
+    bool priceBandsEnabled;
+    PriceBandMonitor priceBands;
+    long long nextSequence = 1; // Time priority handed to the next order entering the book
+    bool auctionsEnabled;
+    bool callPhase = false; // Orders rest without matching until the next uncross
+
+    // Scratch space reused by every uncross
+    std::vector<double> auctionPrices;   // Distinct prices of one instrument, ascending
+    std::vector<long long> buyDepth;     // Buy quantity at or above each price
+    std::vector<long long> sellDepth;    // Sell quantity at or below each price
+    std::vector<Order> auctionReports;   // Execution reports written in one batch
 
     void sortOrderbook();
+    void addRestingOrder(std::vector<Order>& orders, const Order& order);
+    std::vector<Order>::iterator removeRestingOrder(std::vector<Order>& orders, std::vector<Order>::iterator it);
+    std::vector<Order>::iterator replenishIceberg(std::vector<Order>& orders, std::vector<Order>::iterator it);
+    std::vector<Order>::iterator executeMatch(Order& input_order, Order& processed_order,
+                                              std::vector<Order>& restingOrders, std::vector<Order>::iterator it);
+    int linkClientOrder(const Order& order, bool buySide);
+    void unlinkClientOrder(int link);
+    void removeCanceledOrders();
+    void reportCanceled(Order& order, const char* reason);
+    bool preventSelfTrade(Order& input_order, std::vector<Order>& restingOrders, std::vector<Order>::iterator& it);
+    void uncrossInstrument(int instrument);
+    long long executeAuctionOrder(Order& order, double price, long long volumeLeft);
+    void removeFilledOrders(std::vector<Order>& orders);
 
 public:
-    OrderBook(CSVHandler& handler, const std::string& inputFile, const std::string& outputFile);
+    OrderBook(CSVHandler& handler, const std::string& inputFile, const std::string& outputFile, const EngineConfig& config);
+    void reserve(std::size_t buyCount, std::size_t sellCount, int clientCount);
     void processOrder(Order& input_order);
+    void cancelClientOrders(int clientId, const char* reason);
+    void beginAuction();
+    void uncross();
+    bool inAuction() const;
     void printOrderbook();
 };
 
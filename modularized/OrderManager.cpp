@@ -1,33 +1,213 @@
 #include "OrderManager.h"
+#include "AllocationTracker.h"
+#include "FastCSVParser.h"
+#include "Metrics.h"
+#include "SPSCQueue.h"
+#include "ThreadAffinity.h"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <thread>
 
-OrderManager::OrderManager(const std::string& inputFile, const std::string& outputFile)
-    : inputFilename(inputFile), outputFilename(outputFile), csvHandler(), orderBook(csvHandler, inputFile, outputFile) {}
+OrderManager::OrderManager(const std::string& inputFile, const std::string& outputFile, const EngineConfig& config)
+    : inputFilename(inputFile), outputFilename(outputFile), config(config), csvHandler(), orderBook(csvHandler, inputFile, outputFile, config) {}
+
+// Function to pin a pipeline stage thread when a CPU was configured for it
+static void pinStage(const char* stage, int cpu) {
+    if (cpu >= 0 && !pinCurrentThread(cpu)) {
+        std::cerr << "Could not pin " << stage << " thread to CPU " << cpu << std::endl;
+    }
+}
+
+bool OrderManager::processOrders() {
+    if (config.pipeline) return processOrdersPipelined();
 
-void OrderManager::processOrders() {
     // Read the orders from the input CSV file
-    std::vector<Order> orders = csvHandler.readCSV(inputFilename);
-    
+    std::vector<Order> orders = csvHandler.readCSV(inputFilename, config.parseThreads);
+
+    // Intern client names up front so the order book only compares integer ids
+    for (Order& order : orders) {
+        order.clientId = clients.intern(order.client);
+    }
+
     // Write the Execution report headings to CSV
     csvHandler.writeHeadingToCSV(outputFilename);
 
+    // Size the book for the worst case so the matching loop never grows it
+    if (config.zeroAllocation) {
+        std::size_t buyCount = 0;
+        for (const Order& order : orders) {
+            if (order.isBuyOrder()) ++buyCount;
+        }
+        orderBook.reserve(buyCount, orders.size() - buyCount, clients.size());
+    }
+
     // Process each order
+    beginCallPhase();
+    Metrics::recordQueueDepth(QueueStage::Matching, static_cast<long long>(orders.size()));
+    unsigned long long allocationsBefore = AllocationTracker::threadAllocations();
     for (Order& order : orders) {
-        // Check for invalid orders
-        auto [is_valid, reason] = order.isValid();
-        if (is_valid) {
-            orderBook.processOrder(order);
-        } 
-        else {
-            // Reject the order
-            order.status = 1;
-            csvHandler.writeOrderToCSV(outputFilename, order, reason);
+        Metrics::recordQueueDepth(QueueStage::Matching, -1);
+        processOrder(order);
+    }
+
+    // The closing uncross and the disconnect mass-cancel are part of matching too
+    endOfInput();
+    unsigned long long allocations = AllocationTracker::threadAllocations() - allocationsBefore;
+
+    return finishProcessing(orders.size(), allocations);
+}
+
+// Ingest, matching and reporting each run on their own thread, connected by lock-free queues
+bool OrderManager::processOrdersPipelined() {
+    FastCSVParser parser;
+    if (!parser.load(inputFilename)) {
+        std::cerr << "Error opening file: " << inputFilename << std::endl;
+    }
+
+    // The heading is flushed before the reporting thread opens the file
+    csvHandler.writeHeadingToCSV(outputFilename);
+    csvHandler.closeReport();
+
+    // Every row can become at most one resting order and one new client
+    if (config.zeroAllocation) {
+        std::size_t rows = std::count(parser.dataBegin(), parser.dataEnd(), '\n') + 1;
+        orderBook.reserve(rows, rows, static_cast<int>(rows));
+    }
+
+    SPSCQueue<Order> orderQueue(config.queueCapacity);
+    SPSCQueue<ReportRecord> reportQueue(config.queueCapacity);
+    std::atomic<bool> ingestDone{false};
+    std::atomic<bool> matchingDone{false};
+    std::size_t orderCount = 0;
+    unsigned long long allocations = 0;
+
+    csvHandler.forwardReports(&reportQueue, config.waitStrategy);
+
+    std::thread ingest([&]() {
+        pinStage("ingest", config.ingestCpu);
+        Backoff backoff(config.waitStrategy);
+        parser.forEachOrder([&](Order& order) {
+            order.clientId = clients.intern(order.client);
+            while (!orderQueue.tryEmplace(std::move(order))) backoff.pause();
+            backoff.reset();
+            Metrics::recordQueueDepth(QueueStage::Matching, 1);
+        });
+        ingestDone.store(true, std::memory_order_release);
+    });
+
+    std::thread matching([&]() {
+        pinStage("matching", config.matchCpu);
+        Backoff backoff(config.waitStrategy);
+        beginCallPhase();
+        unsigned long long allocationsBefore = AllocationTracker::threadAllocations();
+        while (true) {
+            Order* order = orderQueue.front();
+            if (!order) {
+                // Check the queue again after seeing the flag, the last orders may have just arrived
+                if (ingestDone.load(std::memory_order_acquire) && !orderQueue.front()) break;
+                backoff.pause();
+                continue;
+            }
+            backoff.reset();
+            Metrics::recordQueueDepth(QueueStage::Matching, -1);
+            processOrder(*order);
+            orderQueue.pop();
+            ++orderCount;
+        }
+
+        endOfInput();
+        allocations = AllocationTracker::threadAllocations() - allocationsBefore;
+        matchingDone.store(true, std::memory_order_release);
+    });
+
+    std::thread reporting([&]() {
+        pinStage("reporting", config.reportCpu);
+        CSVHandler writer;
+        Backoff backoff(config.waitStrategy);
+        while (true) {
+            ReportRecord* report = reportQueue.front();
+            if (!report) {
+                if (matchingDone.load(std::memory_order_acquire) && !reportQueue.front()) break;
+                backoff.pause();
+                continue;
+            }
+            backoff.reset();
+            writer.writeOrderToCSV(outputFilename, report->order, report->reason);
+            Metrics::recordQueueDepth(QueueStage::Reporting, -1);
+            reportQueue.pop();
         }
+        writer.closeReport();
+    });
+
+    ingest.join();
+    matching.join();
+    reporting.join();
+    csvHandler.forwardReports(nullptr, config.waitStrategy);
+
+    return finishProcessing(orderCount, allocations);
+}
+
+// Function to validate one order and send it to the order book
+void OrderManager::processOrder(Order& order) {
+    Metrics::recordOrderIn();
+
+    // Check for invalid orders
+    auto [is_valid, reason] = order.isValid();
+    if (is_valid) {
+        orderBook.processOrder(order);
+    }
+    else {
+        // Reject the order
+        order.status = 1;
+        csvHandler.writeOrderToCSV(outputFilename, order, reason);
+    }
+
+    // Uncross once the call phase has collected its orders
+    if (auctionOrdersLeft > 0 && --auctionOrdersLeft == 0) {
+        orderBook.uncross();
+        if (config.periodicAuction) beginCallPhase();
     }
-    
+}
+
+// Function to start collecting orders for a call auction when auctions are enabled
+void OrderManager::beginCallPhase() {
+    if (config.auctionOrders <= 0) return;
+    orderBook.beginAuction();
+    auctionOrdersLeft = config.auctionOrders;
+}
+
+// Function to close the session once the input has ended. An open call phase is uncrossed,
+// then the resting orders of every client are mass-canceled since the clients have disconnected.
+void OrderManager::endOfInput() {
+    if (orderBook.inAuction()) orderBook.uncross();
+    auctionOrdersLeft = 0;
+
+    if (!config.cancelOnDisconnect) return;
+    for (int clientId = 1; clientId <= clients.size(); ++clientId) {
+        orderBook.cancelClientOrders(clientId, "Client disconnected");
+    }
+}
+
+// Function to write the run summary and check the zero-allocation guarantee
+bool OrderManager::finishProcessing(std::size_t orderCount, unsigned long long allocations) {
+    if (config.allocationStats) {
+        csvHandler.writeAllocationsToCSV(outputFilename, allocations, orderCount);
+    }
+    csvHandler.closeReport();
+
+    bool allocationFree = !config.zeroAllocation || allocations == 0;
+    if (!allocationFree) {
+        std::cerr << "Zero-allocation mode: " << allocations << " heap allocations while matching "
+                  << inputFilename << std::endl;
+    }
+
     // Print the final orderbook
-    std::cout << "---------------------" << std::endl;
-    std::cout << "Printing the final orderbook" << std::endl;
-    std::cout << "---------------------" << std::endl;
-    orderBook.printOrderbook();
-}
\ No newline at end of file
+    if (config.trace) {
+        std::cout << "---------------------" << std::endl;
+        std::cout << "Printing the final orderbook" << std::endl;
+        std::cout << "---------------------" << std::endl;
+        orderBook.printOrderbook();
+    }
+    return allocationFree;
+}
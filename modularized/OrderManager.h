@@ -4,6 +4,8 @@
 
 #include "OrderBook.h"
 #include "CSVHandler.h"
+#include "EngineConfig.h"
+#include "ClientRegistry.h"
 
 class OrderManager {
 private:
@@ -11,10 +13,19 @@ private:
     OrderBook orderBook;
     std::string inputFilename;
     std::string outputFilename;
+    EngineConfig config;
+    ClientRegistry clients;
+    long long auctionOrdersLeft = 0; // Orders still to arrive before the call auction uncrosses
+
+    bool processOrdersPipelined();
+    void processOrder(Order& order);
+    void beginCallPhase();
+    void endOfInput();
+    bool finishProcessing(std::size_t orderCount, unsigned long long allocations);
 
 public:
-    OrderManager(const std::string& inputFile, const std::string& outputFile);
-    void processOrders();
+    OrderManager(const std::string& inputFile, const std::string& outputFile, const EngineConfig& config = EngineConfig());
+    bool processOrders();
 };
 
 #endif // ORDERMANAGER_H
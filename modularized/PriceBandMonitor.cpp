@@ -0,0 +1,54 @@
+#include "PriceBandMonitor.h"
+#include <cmath>
+
+PriceBandMonitor::PriceBandMonitor(double bandFraction, double haltMoveFraction, int haltOrders,
+                                   const std::vector<double>& referencePrices)
+    : bandFraction(bandFraction), haltMoveFraction(haltMoveFraction), haltOrders(haltOrders) {
+    for (int i = 0; i < Order::instrumentCount && i < static_cast<int>(referencePrices.size()); ++i) {
+        states[i].referencePrice = referencePrices[i];
+        states[i].anchorPrice = referencePrices[i];
+    }
+}
+
+const char* PriceBandMonitor::check(const Order& order) {
+    int index = order.instrumentIndex();
+    if (index < 0) return nullptr;
+    InstrumentState& state = states[index];
+
+    if (state.haltedOrdersLeft > 0) {
+        --state.haltedOrdersLeft;
+        return "Instrument halted";
+    }
+
+    // No band until the instrument has a reference price
+    if (bandFraction > 0 && state.referencePrice > 0 &&
+        std::fabs(order.price - state.referencePrice) > bandFraction * state.referencePrice) {
+        return "Price out of band";
+    }
+    return nullptr;
+}
+
+bool PriceBandMonitor::recordTrade(int instrument, double price) {
+    if (instrument < 0) return false;
+    InstrumentState& state = states[instrument];
+
+    state.referencePrice = price;
+    if (state.anchorPrice == 0) state.anchorPrice = price;
+
+    if (haltMoveFraction > 0 && std::fabs(price - state.anchorPrice) >= haltMoveFraction * state.anchorPrice) {
+        // Matching resumes from the halt price once the halt has passed
+        state.haltedOrdersLeft = haltOrders;
+        state.anchorPrice = price;
+        return true;
+    }
+    return false;
+}
+
+void PriceBandMonitor::recordResting(const Order& order) {
+    int index = order.instrumentIndex();
+    if (index < 0 || states[index].referencePrice > 0) return;
+
+    // The first sweep is then banded and can halt like any later one
+    states[index].referencePrice = order.price;
+    states[index].anchorPrice = order.price;
+}
@@ -0,0 +1,37 @@
+#ifndef PRICEBANDMONITOR_H
+#define PRICEBANDMONITOR_H
+
+#include <vector>
+#include "Order.h"
+
+// Per-instrument dynamic price bands and volatility halts, updated in O(1) per trade
+class PriceBandMonitor {
+private:
+    struct InstrumentState {
+        double referencePrice = 0; // Last trade price, or the starting reference before the first trade
+        double anchorPrice = 0;    // Price the halt move is measured from
+        int haltedOrdersLeft = 0;  // Orders still rejected by the current halt
+    };
+
+    InstrumentState states[Order::instrumentCount];
+    double bandFraction;
+    double haltMoveFraction;
+    int haltOrders;
+
+public:
+    // referencePrices holds a starting reference per instrument, 0 or missing = none configured
+    PriceBandMonitor(double bandFraction, double haltMoveFraction, int haltOrders,
+                     const std::vector<double>& referencePrices);
+
+    // Returns the reject reason for an incoming order, or nullptr if it may trade
+    const char* check(const Order& order);
+
+    // Updates the reference price after a trade in the instrument with the given index.
+    // Returns true if the trade halted the instrument.
+    bool recordTrade(int instrument, double price);
+
+    // Uses the first order resting on an instrument as its reference when none was configured
+    void recordResting(const Order& order);
+};
+
+#endif // PRICEBANDMONITOR_H
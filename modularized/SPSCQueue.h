@@ -0,0 +1,104 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+#include "EngineConfig.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// Bounded lock-free queue between exactly one producer thread and one consumer thread
+template <typename T>
+class SPSCQueue {
+private:
+    struct alignas(alignof(T)) Slot {
+        unsigned char storage[sizeof(T)];
+    };
+
+    std::size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    alignas(64) std::atomic<std::size_t> head{0}; // Next slot to pop, written by the consumer
+    alignas(64) std::atomic<std::size_t> tail{0}; // Next slot to push, written by the producer
+
+    T* slot(std::size_t index) {
+        return reinterpret_cast<T*>(slots[index & mask].storage);
+    }
+
+public:
+    // Capacity is rounded up to a power of two
+    explicit SPSCQueue(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) size <<= 1;
+        mask = size - 1;
+        slots.reset(new Slot[size]);
+    }
+
+    ~SPSCQueue() {
+        while (front()) pop();
+    }
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    // Constructs the item in place, returns false when the queue is full
+    template <typename... Args>
+    bool tryEmplace(Args&&... args) {
+        std::size_t position = tail.load(std::memory_order_relaxed);
+        if (position - head.load(std::memory_order_acquire) > mask) return false;
+        new (slot(position)) T(std::forward<Args>(args)...);
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Oldest item, or nullptr when the queue is empty. It stays valid until pop().
+    T* front() {
+        std::size_t position = head.load(std::memory_order_relaxed);
+        if (position == tail.load(std::memory_order_acquire)) return nullptr;
+        return slot(position);
+    }
+
+    void pop() {
+        std::size_t position = head.load(std::memory_order_relaxed);
+        slot(position)->~T();
+        head.store(position + 1, std::memory_order_release);
+    }
+};
+
+// Waits between polls of an empty or full queue without giving up the core to the kernel scheduler
+class Backoff {
+private:
+    WaitStrategy strategy;
+    unsigned spins = 0;
+
+    static const unsigned adaptiveSpinLimit = 1024;
+
+public:
+    explicit Backoff(WaitStrategy strategy) : strategy(strategy) {}
+
+    // Call after a poll found nothing to do
+    void pause() {
+        if (strategy == WaitStrategy::Adaptive && spins >= adaptiveSpinLimit) {
+            std::this_thread::yield();
+            return;
+        }
+        ++spins;
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    // Call after a poll made progress
+    void reset() {
+        spins = 0;
+    }
+};
+
+#endif // SPSCQUEUE_H
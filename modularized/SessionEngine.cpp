@@ -0,0 +1,52 @@
+#include "SessionEngine.h"
+#include "OrderManager.h"
+#include "ThreadAffinity.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+SessionEngine::SessionEngine(const std::vector<SessionSpec>& sessions, const EngineConfig& config)
+    : sessions(sessions), config(config) {}
+
+bool SessionEngine::run() {
+    unsigned sessionCount = static_cast<unsigned>(sessions.size());
+    unsigned workerCount = config.sessionWorkers;
+    if (workerCount == 0) workerCount = std::min(sessionCount, static_cast<unsigned>(availableCpuCount()));
+    workerCount = std::max(1u, std::min(workerCount, sessionCount));
+
+    std::vector<std::thread> workers;
+    for (unsigned worker = 0; worker < workerCount; ++worker) {
+        workers.emplace_back(&SessionEngine::runWorker, this, worker, workerCount);
+    }
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+    return allSucceeded;
+}
+
+// Each worker owns sessions worker, worker + workerCount, ... for the whole run
+void SessionEngine::runWorker(unsigned worker, unsigned workerCount) {
+    // By default workers take the CPUs of the process's affinity mask in turn
+    std::vector<int> cpus = allowedCpus();
+    int cpu = worker < config.sessionCpus.size() ? config.sessionCpus[worker] : cpus[worker % cpus.size()];
+    if (!pinCurrentThread(cpu)) {
+        std::cerr << "Could not pin session worker " << worker << " to CPU " << cpu << std::endl;
+    }
+
+    for (std::size_t i = worker; i < sessions.size(); i += workerCount) {
+        const SessionSpec& session = sessions[i];
+
+        // Books are created and grown on the pinned worker, so first-touch
+        // allocation places their memory on the worker's NUMA node
+        auto orderManager = std::make_unique<OrderManager>(session.inputFilename, session.outputFilename, config);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        if (!orderManager->processOrders()) allSucceeded = false;
+        auto end = std::chrono::high_resolution_clock::now();
+
+        long long executionTime = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        CSVHandler().writeExecutionTimeToCSV(session.outputFilename, executionTime);
+    }
+}
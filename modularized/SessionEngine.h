@@ -0,0 +1,29 @@
+#ifndef SESSIONENGINE_H
+#define SESSIONENGINE_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include "EngineConfig.h"
+
+// One isolated trading session: its own input stream, order book set and report file
+struct SessionSpec {
+    std::string inputFilename;
+    std::string outputFilename;
+};
+
+class SessionEngine {
+private:
+    std::vector<SessionSpec> sessions;
+    EngineConfig config;
+    std::atomic<bool> allSucceeded{true};
+
+    void runWorker(unsigned worker, unsigned workerCount);
+
+public:
+    SessionEngine(const std::vector<SessionSpec>& sessions, const EngineConfig& config);
+    // Returns false if any session failed its zero-allocation check
+    bool run();
+};
+
+#endif // SESSIONENGINE_H
@@ -0,0 +1,16 @@
+#ifndef THREADAFFINITY_H
+#define THREADAFFINITY_H
+
+#include <vector>
+
+// Pin the calling thread to one CPU. Returns false where pinning is not supported.
+bool pinCurrentThread(int cpu);
+
+// CPUs the process may run on (its affinity mask, which taskset and cgroups restrict), in ascending order.
+// Never empty: falls back to 0 .. hardware_concurrency() - 1 where the mask cannot be read.
+std::vector<int> allowedCpus();
+
+// Number of CPUs available to the process (at least 1)
+int availableCpuCount();
+
+#endif // THREADAFFINITY_H
@@ -1,32 +1,202 @@
 #include "OrderManager.h"
+#include "EngineConfig.h"
+#include "SessionEngine.h"
+#include "Metrics.h"
+#include "ThreadAffinity.h"
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <sstream>
 #include <string>
 
+// Function to read a comma separated CPU list such as "0,2,4"
+bool parseCpuList(const std::string& text, std::vector<int>& cpus) {
+    std::istringstream ss(text);
+    std::string cpu;
+    while (std::getline(ss, cpu, ',')) {
+        if (cpu.empty()) return false;
+        cpus.push_back(std::atoi(cpu.c_str()));
+    }
+    return !cpus.empty();
+}
+
+// Function to read an instrument reference price such as "Rose=45.50"
+bool parseReferencePrice(const std::string& text, std::vector<double>& referencePrices) {
+    std::size_t separator = text.find('=');
+    if (separator == std::string::npos) return false;
+    std::string instrument = text.substr(0, separator);
+    double price = std::atof(text.c_str() + separator + 1);
+    if (price <= 0) return false;
+
+    for (int i = 0; i < Order::instrumentCount; ++i) {
+        if (instrument == Order::instrumentNames[i]) {
+            referencePrices.resize(Order::instrumentCount, 0);
+            referencePrices[i] = price;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Function to read the optional flags that follow the input and output filenames
+bool parseOptions(int argc, char* argv[], EngineConfig& config, std::vector<SessionSpec>& sessions) {
+    for (int i = 3; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--parse-threads" && i + 1 < argc) {
+            int threads = std::atoi(argv[++i]);
+            if (threads < 1) return false;
+            // More parse threads than usable CPUs only adds thread start-up cost
+            config.parseThreads = static_cast<unsigned>(std::min(threads, availableCpuCount()));
+        }
+        else if (option == "--quiet") {
+            config.trace = false;
+        }
+        else if (option == "--session" && i + 2 < argc) {
+            sessions.push_back({argv[i + 1], argv[i + 2]});
+            i += 2;
+        }
+        else if (option == "--session-workers" && i + 1 < argc) {
+            int workers = std::atoi(argv[++i]);
+            if (workers < 1) return false;
+            config.sessionWorkers = static_cast<unsigned>(workers);
+        }
+        else if (option == "--session-cpus" && i + 1 < argc) {
+            if (!parseCpuList(argv[++i], config.sessionCpus)) return false;
+        }
+        else if (option == "--stp" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "none") config.selfTradePrevention = SelfTradePrevention::None;
+            else if (mode == "cancel-newest") config.selfTradePrevention = SelfTradePrevention::CancelNewest;
+            else if (mode == "cancel-oldest") config.selfTradePrevention = SelfTradePrevention::CancelOldest;
+            else if (mode == "decrement") config.selfTradePrevention = SelfTradePrevention::Decrement;
+            else return false;
+        }
+        else if (option == "--cancel-on-disconnect") {
+            config.cancelOnDisconnect = true;
+        }
+        else if (option == "--alloc-stats") {
+            config.allocationStats = true;
+        }
+        else if (option == "--zero-alloc") {
+            config.zeroAllocation = true;
+        }
+        else if (option == "--price-band" && i + 1 < argc) {
+            config.priceBand = std::atof(argv[++i]);
+            if (config.priceBand < 0) return false;
+        }
+        else if (option == "--halt-move" && i + 1 < argc) {
+            config.haltMove = std::atof(argv[++i]);
+            if (config.haltMove < 0) return false;
+        }
+        else if (option == "--halt-orders" && i + 1 < argc) {
+            config.haltOrders = std::atoi(argv[++i]);
+            if (config.haltOrders < 0) return false;
+        }
+        else if (option == "--reference-price" && i + 1 < argc) {
+            if (!parseReferencePrice(argv[++i], config.referencePrices)) return false;
+        }
+        else if (option == "--metrics-file" && i + 1 < argc) {
+            config.metricsFilename = argv[++i];
+        }
+        else if (option == "--metrics-interval-ms" && i + 1 < argc) {
+            config.metricsIntervalMs = std::atoi(argv[++i]);
+            if (config.metricsIntervalMs < 1) return false;
+        }
+        else if (option == "--pipeline") {
+            config.pipeline = true;
+        }
+        else if (option == "--ingest-cpu" && i + 1 < argc) {
+            config.ingestCpu = std::atoi(argv[++i]);
+        }
+        else if (option == "--match-cpu" && i + 1 < argc) {
+            config.matchCpu = std::atoi(argv[++i]);
+        }
+        else if (option == "--report-cpu" && i + 1 < argc) {
+            config.reportCpu = std::atoi(argv[++i]);
+        }
+        else if (option == "--wait" && i + 1 < argc) {
+            std::string strategy = argv[++i];
+            if (strategy == "busy") config.waitStrategy = WaitStrategy::BusyPoll;
+            else if (strategy == "adaptive") config.waitStrategy = WaitStrategy::Adaptive;
+            else return false;
+        }
+        else if (option == "--queue-capacity" && i + 1 < argc) {
+            int capacity = std::atoi(argv[++i]);
+            if (capacity < 2) return false;
+            config.queueCapacity = static_cast<std::size_t>(capacity);
+        }
+        else if (option == "--auction-orders" && i + 1 < argc) {
+            config.auctionOrders = std::atoll(argv[++i]);
+            if (config.auctionOrders < 1) return false;
+        }
+        else if (option == "--periodic-auction") {
+            config.periodicAuction = true;
+        }
+        else {
+            return false;
+        }
+    }
+    // The uncross matches every crossing order at one price and does not apply self-trade prevention
+    if (config.auctionOrders > 0 && config.selfTradePrevention != SelfTradePrevention::None) {
+        std::cerr << "--stp cannot be combined with --auction-orders" << std::endl;
+        return false;
+    }
+    // Pipeline stages are pinned by the global stage CPUs, which every session would share
+    if (config.pipeline && sessions.size() > 1) {
+        std::cerr << "--pipeline cannot be combined with --session" << std::endl;
+        return false;
+    }
+    return !config.periodicAuction || config.auctionOrders > 0;
+}
+
 int main(int argc, char* argv[]) {
     // Get arguments
-    if (argc != 3) {
-        std::cerr << "Usage: " << argv[0] << " <input_filename> <output_filename>" << std::endl;
+    EngineConfig config;
+    std::vector<SessionSpec> sessions;
+    if (argc >= 3) sessions.push_back({argv[1], argv[2]});
+    if (argc < 3 || !parseOptions(argc, argv, config, sessions)) {
+        std::cerr << "Usage: " << argv[0] << " <input_filename> <output_filename> [--parse-threads N] [--quiet]"
+                  << " [--session <input_filename> <output_filename>]... [--session-workers N] [--session-cpus 0,1,...]"
+                  << " [--stp none|cancel-newest|cancel-oldest|decrement] [--cancel-on-disconnect]"
+                  << " [--alloc-stats] [--zero-alloc] [--price-band FRACTION] [--halt-move FRACTION] [--halt-orders N]"
+                  << " [--reference-price INSTRUMENT=PRICE]..."
+                  << " [--metrics-file PATH] [--metrics-interval-ms N] [--pipeline] [--ingest-cpu N] [--match-cpu N]"
+                  << " [--report-cpu N] [--wait busy|adaptive] [--queue-capacity N] [--auction-orders N] [--periodic-auction]"
+                  << std::endl;
         return 1;
     }
 
+    // Export live metrics for the whole run
+    std::unique_ptr<MetricsExporter> metricsExporter;
+    if (!config.metricsFilename.empty()) {
+        Metrics::enable();
+        metricsExporter = std::make_unique<MetricsExporter>(config.metricsFilename, config.metricsIntervalMs);
+    }
+
+    // Several sessions run isolated on the session engine, each reporting its own execution time
+    if (sessions.size() > 1) {
+        return SessionEngine(sessions, config).run() ? 0 : 1;
+    }
+
     // Get input and output filenames
     std::string inputFilename = argv[1];
     std::string outputFilename = argv[2];
 
     // Instantiate order manager
-    OrderManager orderManager(inputFilename, outputFilename);
+    OrderManager orderManager(inputFilename, outputFilename, config);
 
     // Start timer
     auto start = std::chrono::high_resolution_clock::now();
 
     // Process orders
-    orderManager.processOrders();
+    bool allocationFree = orderManager.processOrders();
     auto end = std::chrono::high_resolution_clock::now();
 
     // Calculate execution time and write to CSV
     long long executionTime = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
     CSVHandler().writeExecutionTimeToCSV(outputFilename, executionTime);
 
-    return 0;
-}
\ No newline at end of file
+    return allocationFree ? 0 : 1;
+}
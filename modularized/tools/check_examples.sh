@@ -0,0 +1,43 @@
+#!/bin/bash
+# Regression check of the execution reports. Runs flower_trader on the in-person examples and on the
+# examples that cover partial fills, icebergs, self-trade prevention and auctions, and compares each
+# report with the stored one. The Execution Time row is ignored.
+# Usage (from the modularized folder, after building flower_trader): tools/check_examples.sh
+# FLOWER_TRADER selects another engine binary, the default is ./flower_trader.
+cd "$(dirname "$0")/.." || exit 1
+engine=${FLOWER_TRADER:-./flower_trader}
+
+if [ ! -x "$engine" ]; then
+    echo "Build flower_trader first" >&2
+    exit 1
+fi
+mkdir -p load
+
+failed=0
+
+# Function to run one input and compare its report: input, expected report, then flower_trader flags
+check() {
+    local input=$1 expected=$2
+    shift 2
+    "$engine" "$input" load/example_report.csv --quiet "$@" || { failed=1; return; }
+    if ! diff <(grep -v '^Execution Time' load/example_report.csv) \
+              <(grep -v '^Execution Time' "$expected" | tr -d '\r') > /dev/null; then
+        echo "FAILED: $input $*" >&2
+        failed=1
+    fi
+}
+
+for input in inperson_examples/ex*_*.csv; do
+    name=$(basename "$input")
+    check "$input" "inperson_outputs/${name%%_*}.csv"
+done
+
+check examples/example9.csv execution_reports/execution9.csv                     # Partial fills and time priority
+check examples/example10.csv execution_reports/execution10.csv                   # Iceberg replenishing
+check examples/example11.csv execution_reports/execution11.csv --stp cancel-newest
+check examples/example12.csv execution_reports/execution12.csv --stp cancel-oldest --cancel-on-disconnect
+check examples/example13.csv execution_reports/execution13.csv --stp decrement --cancel-on-disconnect
+check examples/example14.csv execution_reports/execution14.csv --auction-orders 5   # Opening uncross
+
+[ $failed -eq 0 ] && echo "Example reports match"
+exit $failed
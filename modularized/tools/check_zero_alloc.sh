@@ -0,0 +1,55 @@
+#!/bin/bash
+# Zero-allocation regression target. Runs flower_trader with --zero-alloc --alloc-stats over the example
+# inputs, a generated load file and a file of long ids, serially and pipelined, and fails on any non-zero exit.
+# Usage (from the modularized folder, after building flower_trader): tools/check_zero_alloc.sh
+# FLOWER_TRADER selects another engine binary, the default is ./flower_trader.
+cd "$(dirname "$0")/.." || exit 1
+engine=${FLOWER_TRADER:-./flower_trader}
+
+mkdir -p tools/build load
+g++ -std=c++17 -O2 tools/load_generator.cpp -o tools/build/load_generator || exit 1
+if [ ! -x "$engine" ]; then
+    echo "Build flower_trader first" >&2
+    exit 1
+fi
+
+[ -f load/zero_alloc_100k.csv ] || tools/build/load_generator --orders 100000 --seed 3 --cancel-ratio 0.3 \
+    --reject-ratio 0.05 --aggressiveness 0.5 --output load/zero_alloc_100k.csv || exit 1
+
+# Ids, instruments and clients well past the 15 character small-string buffer of libstdc++
+cat > load/zero_alloc_long_ids.csv <<'EOF'
+Cl. Ord. ID,Instrument,Side,Quantity,Price,Client
+client-order-id-000000000001,Rose,2,100,55.00,trading-desk-account-0001
+client-order-id-000000000002,Rose,2,200,56.00,trading-desk-account-0002
+client-order-id-000000000003,Rose,1,250,56.00,trading-desk-account-0003
+client-order-id-000000000004,Lavender,1,100,12.50,trading-desk-account-0001
+client-order-id-000000000005,Lavender,2,300,12.00,trading-desk-account-0002
+client-order-id-000000000006,Lotus,1,100,80.00,trading-desk-account-0003
+client-order-id-000000000007,Lotus,2,100,79.00,trading-desk-account-0003
+client-order-id-000000000008,UnknownInstrumentName,1,100,10.00,trading-desk-account-0004
+client-order-id-000000000009,Tulip,1,150,-5.00,trading-desk-account-0004
+client-order-id-000000000010,Orchid,2,100,30.00,trading-desk-account-0005
+EOF
+
+failed=0
+
+# Function to run one input with the given extra flags
+check() {
+    local file=$1
+    shift
+    if ! "$engine" "$file" load/zero_alloc_report.csv --quiet --zero-alloc --alloc-stats "$@"; then
+        echo "FAILED: $file $*" >&2
+        failed=1
+    fi
+}
+
+for file in examples/*.csv inperson_examples/*.csv load/zero_alloc_100k.csv load/zero_alloc_long_ids.csv; do
+    check "$file"
+    check "$file" --pipeline
+done
+check load/zero_alloc_long_ids.csv --stp cancel-oldest --cancel-on-disconnect
+check load/zero_alloc_100k.csv --stp decrement --cancel-on-disconnect
+check load/zero_alloc_100k.csv --auction-orders 1000 --periodic-auction
+
+[ $failed -eq 0 ] && echo "Zero-allocation check passed"
+exit $failed
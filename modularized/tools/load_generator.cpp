@@ -0,0 +1,208 @@
+// Synthetic order file generator for load and throughput tests of flower_trader
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+const int instrumentCount = 5;
+const char* const instrumentNames[instrumentCount] = {"Rose", "Lavender", "Lotus", "Tulip", "Orchid"};
+
+struct GeneratorConfig {
+    long long orders = 1000000;
+    unsigned seed = 1;
+    double instrumentSkew = 1.0;  // Zipf exponent over the instruments, 0 = uniform
+    double volatility = 0.001;    // Standard deviation of each relative step of an instrument's price walk
+    double depth = 0.01;          // Orders are priced up to this fraction away from the current price
+    double aggressiveness = 0.3;  // Fraction of orders priced through the current price
+    double cancelRatio = 0;       // Fraction of orders sent by named clients, see README
+    int clients = 100;            // Named clients the cancel ratio is spread over
+    double rejectRatio = 0.01;    // Fraction of orders with an invalid field
+    std::string outputFilename = "-";
+};
+
+// Buffered writer, rows are formatted into a large buffer and written in blocks
+class RowWriter {
+private:
+    std::FILE* file;
+    std::vector<char> buffer;
+    std::size_t used = 0;
+
+public:
+    explicit RowWriter(std::FILE* file) : file(file), buffer(1 << 20) {}
+
+    void flush() {
+        std::fwrite(buffer.data(), 1, used, file);
+        used = 0;
+    }
+
+    void append(const char* text, std::size_t length) {
+        if (used + length > buffer.size()) flush();
+        std::copy(text, text + length, buffer.data() + used);
+        used += length;
+    }
+
+    void append(const char* text) { append(text, std::char_traits<char>::length(text)); }
+
+    void append(char c) { append(&c, 1); }
+
+    void append(long long value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        append(digits, result.ptr - digits);
+    }
+
+    // Prices are written with two decimals like the example inputs
+    void appendPrice(long long cents) {
+        if (cents < 0) {
+            append('-');
+            cents = -cents;
+        }
+        append(cents / 100);
+        append('.');
+        append(static_cast<char>('0' + cents / 10 % 10));
+        append(static_cast<char>('0' + cents % 10));
+    }
+};
+
+// Function to read a fraction option, which must lie in [0, 1]
+bool parseFraction(const char* text, double& value) {
+    value = std::atof(text);
+    return value >= 0 && value <= 1;
+}
+
+// Function to read the generator options
+bool parseOptions(int argc, char* argv[], GeneratorConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+
+        if (option == "--orders") {
+            config.orders = std::atoll(value);
+            if (config.orders < 1) return false;
+        }
+        else if (option == "--seed") {
+            config.seed = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        }
+        else if (option == "--instrument-skew") {
+            config.instrumentSkew = std::atof(value);
+            if (config.instrumentSkew < 0) return false;
+        }
+        else if (option == "--volatility") {
+            config.volatility = std::atof(value);
+            if (config.volatility < 0) return false;
+        }
+        else if (option == "--depth") {
+            if (!parseFraction(value, config.depth)) return false;
+        }
+        else if (option == "--aggressiveness") {
+            if (!parseFraction(value, config.aggressiveness)) return false;
+        }
+        else if (option == "--cancel-ratio") {
+            if (!parseFraction(value, config.cancelRatio)) return false;
+        }
+        else if (option == "--clients") {
+            config.clients = std::atoi(value);
+            if (config.clients < 1) return false;
+        }
+        else if (option == "--reject-ratio") {
+            if (!parseFraction(value, config.rejectRatio)) return false;
+        }
+        else if (option == "--output") {
+            config.outputFilename = value;
+        }
+        else {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    GeneratorConfig config;
+    if (!parseOptions(argc, argv, config)) {
+        std::cerr << "Usage: " << argv[0] << " [--orders N] [--seed N] [--instrument-skew S] [--volatility SIGMA]"
+                  << " [--depth FRACTION] [--aggressiveness FRACTION] [--cancel-ratio FRACTION] [--clients N]"
+                  << " [--reject-ratio FRACTION] [--output PATH|-]" << std::endl;
+        return 1;
+    }
+
+    std::FILE* file = config.outputFilename == "-" ? stdout : std::fopen(config.outputFilename.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error opening file: " << config.outputFilename << std::endl;
+        return 1;
+    }
+
+    std::mt19937_64 rng(config.seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::normal_distribution<double> step(0.0, 1.0);
+    std::uniform_int_distribution<int> lots(1, 99);
+    std::uniform_int_distribution<int> clientPick(1, config.clients);
+    std::uniform_int_distribution<int> defectPick(0, 4);
+
+    // Instrument i is picked with weight 1 / (i + 1)^skew
+    std::vector<double> weights;
+    for (int i = 0; i < instrumentCount; ++i) weights.push_back(1.0 / std::pow(i + 1, config.instrumentSkew));
+    std::discrete_distribution<int> instrumentPick(weights.begin(), weights.end());
+
+    // Each instrument's price follows its own geometric random walk
+    std::vector<double> prices(instrumentCount, 100.0);
+
+    RowWriter writer(file);
+    writer.append(config.cancelRatio > 0 ? "Cl. Ord. ID,Instrument,Side,Quantity,Price,Client\n" :
+                                           "Cl. Ord. ID,Instrument,Side,Quantity,Price\n");
+
+    for (long long i = 0; i < config.orders; ++i) {
+        int instrument = instrumentPick(rng);
+        double& price = prices[instrument];
+        price = std::max(1.0, price * std::exp(config.volatility * step(rng)));
+
+        int side = unit(rng) < 0.5 ? 1 : 2;
+        long long quantity = lots(rng) * 10;
+
+        // Aggressive orders cross the current price, passive orders rest behind it
+        bool aggressive = unit(rng) < config.aggressiveness;
+        double offset = config.depth * unit(rng);
+        bool above = (side == 1) == aggressive;
+        long long cents = std::max(1LL, std::llround(price * (above ? 1 + offset : 1 - offset) * 100));
+
+        const char* instrumentName = instrumentNames[instrument];
+        bool emptyId = false;
+        if (unit(rng) < config.rejectRatio) {
+            switch (defectPick(rng)) {
+            case 0: instrumentName = "Mango"; break;
+            case 1: quantity += 5; break;
+            case 2: cents = -cents; break;
+            case 3: side = 3; break;
+            default: emptyId = true; break;
+            }
+        }
+
+        if (!emptyId) {
+            writer.append('c');
+            writer.append(i + 1);
+        }
+        writer.append(',');
+        writer.append(instrumentName);
+        writer.append(',');
+        writer.append(static_cast<long long>(side));
+        writer.append(',');
+        writer.append(quantity);
+        writer.append(',');
+        writer.appendPrice(cents);
+        if (config.cancelRatio > 0 && unit(rng) < config.cancelRatio) {
+            writer.append(",client");
+            writer.append(static_cast<long long>(clientPick(rng)));
+        }
+        writer.append('\n');
+    }
+
+    writer.flush();
+    if (file != stdout) std::fclose(file);
+    return 0;
+}
@@ -0,0 +1,45 @@
+#!/bin/bash
+# Throughput regression target. Builds the tools, generates the load files once and checks every
+# scenario against tools/throughput_baseline.csv. Pass --update-baseline to record new numbers.
+# Usage (from the modularized folder, after building flower_trader): tools/run_throughput.sh [--update-baseline]
+# FLOWER_TRADER selects another engine binary, the default is ./flower_trader.
+cd "$(dirname "$0")/.." || exit 1
+engine=${FLOWER_TRADER:-./flower_trader}
+
+mkdir -p tools/build load
+g++ -std=c++17 -O2 tools/load_generator.cpp -o tools/build/load_generator || exit 1
+g++ -std=c++17 -O2 tools/throughput.cpp -o tools/build/throughput || exit 1
+if [ ! -x "$engine" ]; then
+    echo "Build flower_trader first" >&2
+    exit 1
+fi
+
+# Function to generate a load file unless it already exists
+generate() {
+    local file=$1
+    shift
+    [ -f "load/$file" ] || tools/build/load_generator "$@" --output "load/$file" || exit 1
+}
+
+generate orders_100k.csv --orders 100000 --seed 1
+generate orders_1m.csv --orders 1000000 --seed 1
+generate skewed_100k.csv --orders 100000 --seed 2 --instrument-skew 2 --cancel-ratio 0.2 --reject-ratio 0.05 --aggressiveness 0.5
+
+failed=0
+
+# Function to run one scenario: name, load file, then flower_trader flags
+scenario() {
+    local name=$1 file=$2
+    shift 2
+    tools/build/throughput "$engine" "load/$file" tools/throughput_baseline.csv --name "$name" \
+        --report "load/${name}_report.csv" "${options[@]}" -- "$@" || failed=1
+}
+
+options=("$@")
+scenario continuous_100k orders_100k.csv --quiet
+scenario pipeline_100k orders_100k.csv --quiet --pipeline
+scenario skewed_clients_100k skewed_100k.csv --quiet --stp cancel-newest --cancel-on-disconnect
+scenario call_auction_1m orders_1m.csv --quiet --auction-orders 1000000
+scenario periodic_auction_1m orders_1m.csv --quiet --periodic-auction --auction-orders 10000
+
+exit $failed
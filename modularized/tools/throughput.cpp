@@ -0,0 +1,226 @@
+// End-to-end throughput check: runs flower_trader on an input file and compares
+// orders/sec, peak RSS and report bytes/sec with a stored baseline
+#include <chrono>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+struct ThroughputResult {
+    std::string name;
+    long long orders = 0;
+    double ordersPerSecond = 0;
+    long long peakRssKb = 0;
+    double reportBytesPerSecond = 0;
+};
+
+struct RunOptions {
+    std::string name = "default";
+    std::string reportFilename = "throughput_report.csv";
+    double tolerance = 0.10; // Allowed relative drop in throughput, or growth in RSS
+    bool updateBaseline = false;
+    std::vector<std::string> engineFlags;
+};
+
+// Function to count the data rows of a CSV file, the header row excluded
+long long countOrders(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error opening file: " << filename << std::endl;
+        return -1;
+    }
+
+    std::vector<char> block(1 << 20);
+    long long lines = 0;
+    char last = '\n';
+    while (file.read(block.data(), block.size()) || file.gcount() > 0) {
+        std::streamsize count = file.gcount();
+        for (std::streamsize i = 0; i < count; ++i) lines += block[i] == '\n';
+        last = block[count - 1];
+    }
+    if (last != '\n') ++lines;
+    return lines > 0 ? lines - 1 : 0;
+}
+
+// Function to run flower_trader once with stdout discarded, returns false if it failed
+bool runEngine(const std::string& engine, const std::string& inputFilename, const RunOptions& options,
+               double& seconds, long long& peakRssKb) {
+    std::vector<std::string> arguments = {engine, inputFilename, options.reportFilename};
+    arguments.insert(arguments.end(), options.engineFlags.begin(), options.engineFlags.end());
+    std::vector<char*> argv;
+    for (std::string& argument : arguments) argv.push_back(&argument[0]);
+    argv.push_back(nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0) return false;
+    if (pid == 0) {
+        int devNull = open("/dev/null", O_WRONLY);
+        if (devNull >= 0) dup2(devNull, STDOUT_FILENO);
+        execv(engine.c_str(), argv.data());
+        _exit(127);
+    }
+
+    // wait4 reports the peak resident set of the child alone
+    int status = 0;
+    struct rusage usage = {};
+    if (wait4(pid, &status, 0, &usage) < 0) return false;
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    peakRssKb = usage.ru_maxrss;
+
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::cerr << engine << " failed with status " << (WIFEXITED(status) ? WEXITSTATUS(status) : -1) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Function to read the baseline rows: Name,Orders,Orders per second,Peak RSS (KB),Report bytes per second
+std::vector<ThroughputResult> readBaseline(const std::string& filename) {
+    std::vector<ThroughputResult> results;
+    std::ifstream file(filename);
+    std::string line;
+    std::getline(file, line); // Skip the header
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+        std::istringstream ss(line);
+        ThroughputResult result;
+        std::string field;
+        std::getline(ss, result.name, ',');
+        std::getline(ss, field, ',');
+        result.orders = std::atoll(field.c_str());
+        std::getline(ss, field, ',');
+        result.ordersPerSecond = std::atof(field.c_str());
+        std::getline(ss, field, ',');
+        result.peakRssKb = std::atoll(field.c_str());
+        std::getline(ss, field, ',');
+        result.reportBytesPerSecond = std::atof(field.c_str());
+        results.push_back(result);
+    }
+    return results;
+}
+
+// Function to write the baseline rows back to the file
+bool writeBaseline(const std::string& filename, const std::vector<ThroughputResult>& results) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error opening file: " << filename << std::endl;
+        return false;
+    }
+    file << "Name,Orders,Orders per second,Peak RSS (KB),Report bytes per second" << '\n';
+    for (const ThroughputResult& result : results) {
+        file << result.name << "," << result.orders << "," << std::fixed << std::setprecision(0)
+             << result.ordersPerSecond << "," << result.peakRssKb << "," << result.reportBytesPerSecond << '\n';
+    }
+    return true;
+}
+
+// Function to print one measurement next to its baseline value, returns false on a regression
+bool compareMetric(const char* metric, double current, double baseline, double tolerance, bool higherIsBetter) {
+    double change = baseline > 0 ? (current - baseline) / baseline : 0;
+    bool regressed = higherIsBetter ? change < -tolerance : change > tolerance;
+    std::cout << std::left << std::setw(26) << metric << std::right << std::fixed << std::setprecision(0)
+              << std::setw(16) << current << std::setw(16) << baseline
+              << std::setw(9) << std::setprecision(1) << change * 100 << "%"
+              << (regressed ? "  REGRESSION" : "") << std::endl;
+    return !regressed;
+}
+
+// Function to read the options that follow the engine, input and baseline paths
+bool parseOptions(int argc, char* argv[], RunOptions& options) {
+    for (int i = 4; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--") {
+            options.engineFlags.assign(argv + i + 1, argv + argc);
+            return true;
+        }
+        else if (option == "--name" && i + 1 < argc) {
+            options.name = argv[++i];
+            if (options.name.find(',') != std::string::npos) return false;
+        }
+        else if (option == "--report" && i + 1 < argc) {
+            options.reportFilename = argv[++i];
+        }
+        else if (option == "--tolerance" && i + 1 < argc) {
+            options.tolerance = std::atof(argv[++i]);
+            if (options.tolerance < 0) return false;
+        }
+        else if (option == "--update-baseline") {
+            options.updateBaseline = true;
+        }
+        else {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    RunOptions options;
+    if (argc < 4 || !parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " <flower_trader> <input_filename> <baseline_filename> [--name NAME]"
+                  << " [--report PATH] [--tolerance FRACTION] [--update-baseline] [-- flower_trader flags...]" << std::endl;
+        return 1;
+    }
+    std::string engine = argv[1];
+    std::string inputFilename = argv[2];
+    std::string baselineFilename = argv[3];
+
+    ThroughputResult current;
+    current.name = options.name;
+    current.orders = countOrders(inputFilename);
+    if (current.orders < 0) return 1;
+
+    double seconds = 0;
+    if (!runEngine(engine, inputFilename, options, seconds, current.peakRssKb)) return 1;
+
+    struct stat report = {};
+    if (stat(options.reportFilename.c_str(), &report) != 0) {
+        std::cerr << "Error opening file: " << options.reportFilename << std::endl;
+        return 1;
+    }
+    current.ordersPerSecond = current.orders / seconds;
+    current.reportBytesPerSecond = report.st_size / seconds;
+
+    std::vector<ThroughputResult> baseline = readBaseline(baselineFilename);
+    ThroughputResult* stored = nullptr;
+    for (ThroughputResult& result : baseline) {
+        if (result.name == current.name) stored = &result;
+    }
+
+    if (options.updateBaseline) {
+        if (stored) *stored = current;
+        else baseline.push_back(current);
+        std::cout << "Baseline " << current.name << " updated: " << std::fixed << std::setprecision(0)
+                  << current.ordersPerSecond << " orders/sec, " << current.peakRssKb << " KB peak RSS, "
+                  << current.reportBytesPerSecond << " report bytes/sec" << std::endl;
+        return writeBaseline(baselineFilename, baseline) ? 0 : 1;
+    }
+
+    if (!stored) {
+        std::cerr << "No baseline named " << current.name << " in " << baselineFilename
+                  << ", record one with --update-baseline" << std::endl;
+        return 1;
+    }
+    if (stored->orders != current.orders) {
+        std::cerr << "Warning: baseline " << current.name << " was recorded with " << stored->orders
+                  << " orders, this input has " << current.orders << std::endl;
+    }
+
+    std::cout << current.name << ": " << current.orders << " orders in " << std::setprecision(3) << seconds << " s" << std::endl;
+    std::cout << std::left << std::setw(26) << "Metric" << std::right << std::setw(16) << "Current"
+              << std::setw(16) << "Baseline" << std::setw(10) << "Change" << std::endl;
+    bool passed = compareMetric("Orders per second", current.ordersPerSecond, stored->ordersPerSecond, options.tolerance, true);
+    passed = compareMetric("Peak RSS (KB)", current.peakRssKb, stored->peakRssKb, options.tolerance, false) && passed;
+    passed = compareMetric("Report bytes per second", current.reportBytesPerSecond, stored->reportBytesPerSecond,
+                           options.tolerance, true) && passed;
+    return passed ? 0 : 1;
+}